@@ -0,0 +1,49 @@
+#include "ApplicabilityCache.h"
+
+namespace DBD
+{
+	bool ApplicabilityCache::IsApplicable(const ProfileBase* a_profile, RE::Actor* a_target)
+	{
+		const auto base = a_target->GetActorBase();
+		const Signature signature{ a_target->GetSkin(), a_target->GetRace(), base ? base->GetSex() : RE::SEX::kNone };
+		const auto index = a_profile->GetIndex();
+		const auto word = index / 64;
+		const auto bit = uint64_t{ 1 } << (index % 64);
+		{
+			std::scoped_lock guard{ lock };
+			if (index >= numProfiles) {
+				return a_profile->IsApplicable(a_target);
+			}
+			const auto it = entries.find(signature);
+			if (it != entries.end() && (it->second.known[word] & bit)) {
+				return (it->second.applicable[word] & bit) != 0;
+			}
+		}
+		// Evaluate outside of the lock, the result is the same for every thread
+		const auto result = a_profile->IsApplicable(a_target);
+		std::scoped_lock guard{ lock };
+		if (index >= numProfiles) {
+			return result;
+		}
+		auto [it, inserted] = entries.try_emplace(signature);
+		auto& entry = it->second;
+		if (inserted) {
+			const auto numWords = (numProfiles + 63) / 64;
+			entry.known.resize(numWords);
+			entry.applicable.resize(numWords);
+		}
+		entry.known[word] |= bit;
+		if (result) {
+			entry.applicable[word] |= bit;
+		}
+		return result;
+	}
+
+	void ApplicabilityCache::Reset(uint32_t a_numProfiles)
+	{
+		std::scoped_lock guard{ lock };
+		entries.clear();
+		numProfiles = a_numProfiles;
+	}
+
+}  // namespace DBD
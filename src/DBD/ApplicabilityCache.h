@@ -0,0 +1,51 @@
+#pragma once
+
+#include "ProfileBase.h"
+
+namespace DBD
+{
+	/// @brief Memoized results of ProfileBase::IsApplicable
+	/// Applicability of a profile only depends on the skin, race and sex of an actor, the results are thus stored once per
+	/// such signature as a bitset over all profile indices.
+	class ApplicabilityCache final
+	{
+	public:
+		ApplicabilityCache() = delete;
+
+		static bool IsApplicable(const ProfileBase* a_profile, RE::Actor* a_target);
+		/// @brief Drop all results, to be called whenever the set of profiles changes
+		static void Reset(uint32_t a_numProfiles);
+
+	private:
+		struct Signature
+		{
+			RE::TESObjectARMO* skin;
+			RE::TESRace* race;
+			RE::SEX sex;
+
+			bool operator==(const Signature&) const = default;
+		};
+		struct SignatureHash
+		{
+			size_t operator()(const Signature& a_signature) const
+			{
+				const auto hash = std::hash<const void*>{};
+				size_t ret = hash(a_signature.skin);
+				ret ^= hash(a_signature.race) + 0x9e3779b9 + (ret << 6) + (ret >> 2);
+				ret ^= std::to_underlying(a_signature.sex) + 0x9e3779b9 + (ret << 6) + (ret >> 2);
+				return ret;
+			}
+		};
+		struct Entry
+		{
+			std::vector<uint64_t> known;
+			std::vector<uint64_t> applicable;
+		};
+
+	private:
+		static inline std::mutex lock{};
+		static inline uint32_t numProfiles{ 0 };
+		static inline std::unordered_map<Signature, Entry, SignatureHash> entries{};
+	};
+
+}  // namespace DBD
@@ -0,0 +1,80 @@
+#include "ApplyQueue.h"
+
+#include "DBD/Distribution.h"
+#include "DBD/Settings.h"
+
+namespace DBD
+{
+	void ApplyQueue::Push(RE::FormID a_formID)
+	{
+		std::scoped_lock guard{ lock };
+		if (queued.insert(a_formID).second) {
+			pending.push_back(a_formID);
+		}
+	}
+
+	void ApplyQueue::Process()
+	{
+		const auto start = Clock::now();
+		const auto budget = std::chrono::microseconds{ Settings::applyBudget };
+		std::vector<RE::FormID> work;
+		{
+			std::scoped_lock guard{ lock };
+			if (pending.empty()) {
+				return;
+			}
+			work.swap(pending);
+			queued.clear();
+		}
+		const auto player = RE::PlayerCharacter::GetSingleton();
+		std::vector<std::pair<float, RE::Actor*>> order;
+		order.reserve(work.size());
+		for (const auto formID : work) {
+			const auto actor = RE::TESForm::LookupByID<RE::Actor>(formID);
+			if (actor && actor->Is3DLoaded()) {
+				order.emplace_back(GetPriority(actor, player), actor);
+			}
+		}
+		std::ranges::sort(order, {}, &std::pair<float, RE::Actor*>::first);
+		std::vector<RE::Actor*> targets;
+		targets.reserve(order.size());
+		std::ranges::transform(order, std::back_inserter(targets), &std::pair<float, RE::Actor*>::second);
+
+		// At least one batch is processed every frame, so the queue drains even if a single batch exceeds the budget
+		const auto distribution = Distribution::GetSingleton();
+		size_t processed = 0;
+		while (processed < targets.size()) {
+			const auto count = std::min(BATCH_SIZE, targets.size() - processed);
+			distribution->ApplyProfiles(std::span{ targets }.subspan(processed, count));
+			processed += count;
+			if (budget.count() > 0 && Clock::now() - start >= budget) {
+				break;
+			}
+		}
+		if (processed == targets.size()) {
+			return;
+		}
+
+		{
+			std::scoped_lock guard{ lock };
+			for (size_t i = processed; i < targets.size(); i++) {
+				const auto formID = targets[i]->GetFormID();
+				if (queued.insert(formID).second) {
+					pending.push_back(formID);
+				}
+			}
+		}
+		logger::debug("Applied profiles to {} actors, {} left for the next frame", processed, targets.size() - processed);
+	}
+
+	float ApplyQueue::GetPriority(RE::Actor* a_target, RE::PlayerCharacter* a_player)
+	{
+		if (a_target->IsPlayerRef()) {
+			return -2.0f;
+		} else if (a_target->IsPlayerTeammate()) {
+			return -1.0f;
+		}
+		return a_player ? a_target->GetPosition().GetSquaredDistance(a_player->GetPosition()) : 0.0f;
+	}
+
+}  // namespace DBD
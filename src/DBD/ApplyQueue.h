@@ -0,0 +1,32 @@
+#pragma once
+
+#include "shared/KrisV/Singleton.h"
+
+namespace DBD
+{
+	/// @brief Actors waiting for their profiles to be applied, processed on the main thread within a per frame time budget
+	/// Every actor is queued at most once. Each frame the queue is ordered with the player first, followed by followers and
+	/// then all other actors by their distance to the player. Actors left over once the budget is spent wait for the next frame.
+	class ApplyQueue final :
+		public Singleton<ApplyQueue>
+	{
+		using Clock = std::chrono::steady_clock;
+
+		// Actors handed to the distribution at once, the budget is checked between batches
+		static constexpr size_t BATCH_SIZE{ 8 };
+
+	public:
+		void Push(RE::FormID a_formID);
+		/// @brief Apply profiles to queued actors until the budget is spent, to be called once per frame on the main thread
+		void Process();
+
+	private:
+		static float GetPriority(RE::Actor* a_target, RE::PlayerCharacter* a_player);
+
+	private:
+		std::mutex lock;
+		std::vector<RE::FormID> pending;
+		std::unordered_set<RE::FormID> queued;
+	};
+
+}  // namespace DBD
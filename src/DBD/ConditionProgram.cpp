@@ -0,0 +1,243 @@
+#include "ConditionProgram.h"
+
+#include "shared/KrisV/Util/String.h"
+
+namespace DBD
+{
+	struct ConditionProgram::EventTracker :
+		public RE::BSTEventSink<RE::TESQuestStageEvent>,
+		public RE::BSTEventSink<RE::TESQuestStartStopEvent>,
+		public RE::BSTEventSink<RE::TESEquipEvent>,
+		public RE::BSTEventSink<RE::TESSwitchRaceCompleteEvent>,
+		public RE::BSTEventSink<RE::MenuOpenCloseEvent>
+	{
+		RE::BSEventNotifyControl ProcessEvent(const RE::TESQuestStageEvent*, RE::BSTEventSource<RE::TESQuestStageEvent>*) override
+		{
+			questEpoch.fetch_add(1, std::memory_order_relaxed);
+			return RE::BSEventNotifyControl::kContinue;
+		}
+
+		RE::BSEventNotifyControl ProcessEvent(const RE::TESQuestStartStopEvent*, RE::BSTEventSource<RE::TESQuestStartStopEvent>*) override
+		{
+			questEpoch.fetch_add(1, std::memory_order_relaxed);
+			return RE::BSEventNotifyControl::kContinue;
+		}
+
+		RE::BSEventNotifyControl ProcessEvent(const RE::TESEquipEvent*, RE::BSTEventSource<RE::TESEquipEvent>*) override
+		{
+			equipmentEpoch.fetch_add(1, std::memory_order_relaxed);
+			return RE::BSEventNotifyControl::kContinue;
+		}
+
+		RE::BSEventNotifyControl ProcessEvent(const RE::TESSwitchRaceCompleteEvent*, RE::BSTEventSource<RE::TESSwitchRaceCompleteEvent>*) override
+		{
+			raceEpoch.fetch_add(1, std::memory_order_relaxed);
+			return RE::BSEventNotifyControl::kContinue;
+		}
+
+		RE::BSEventNotifyControl ProcessEvent(const RE::MenuOpenCloseEvent* a_event, RE::BSTEventSource<RE::MenuOpenCloseEvent>*) override
+		{
+			// The player may have changed race or sex in character creation
+			if (a_event && !a_event->opening && a_event->menuName == RE::RaceSexMenu::MENU_NAME) {
+				raceEpoch.fetch_add(1, std::memory_order_relaxed);
+			}
+			return RE::BSEventNotifyControl::kContinue;
+		}
+	};
+
+	ConditionProgram::ConditionProgram(const std::vector<std::string>& a_rawConditions, const Conditions::RefMap& a_refMap) :
+		conditions(Conditions::ConditionParser::ParseConditions(a_rawConditions, a_refMap))
+	{
+		Compile();
+	}
+
+	bool ConditionProgram::ConditionsMet(RE::TESObjectREFR* a_subject, RE::TESObjectREFR* a_target) const
+	{
+		RE::ConditionCheckParams params{ a_subject, a_target };
+		size_t pc = 0;
+		while (pc < program.size()) {
+			const auto& instruction = program[pc];
+			pc = IsTrue(instruction, params) ? instruction.onTrue : instruction.onFalse;
+		}
+		return pc != Instruction::FAIL;
+	}
+
+	uint64_t ConditionProgram::GetStamp() const
+	{
+		// Every epoch only ever grows, so does their sum
+		uint64_t stamp = bindingEpoch.load(std::memory_order_relaxed);
+		if (dependencies & kQuest) {
+			stamp += questEpoch.load(std::memory_order_relaxed);
+		}
+		if (dependencies & kEquipment) {
+			stamp += equipmentEpoch.load(std::memory_order_relaxed);
+		}
+		if (dependencies & kRace) {
+			stamp += raceEpoch.load(std::memory_order_relaxed);
+		}
+		if (dependencies & kPolled) {
+			stamp += RE::GetDurationOfApplicationRunTime();
+		}
+		return stamp;
+	}
+
+	void ConditionProgram::RegisterEventSinks()
+	{
+		static EventTracker tracker{};
+		const auto holder = RE::ScriptEventSourceHolder::GetSingleton();
+		holder->AddEventSink<RE::TESQuestStageEvent>(&tracker);
+		holder->AddEventSink<RE::TESQuestStartStopEvent>(&tracker);
+		holder->AddEventSink<RE::TESEquipEvent>(&tracker);
+		holder->AddEventSink<RE::TESSwitchRaceCompleteEvent>(&tracker);
+		if (const auto ui = RE::UI::GetSingleton()) {
+			ui->AddEventSink<RE::MenuOpenCloseEvent>(&tracker);
+		}
+	}
+
+	void ConditionProgram::Compile()
+	{
+		for (auto ptr = conditions ? conditions->head : nullptr; ptr; ptr = ptr->next) {
+			auto& instruction = program.emplace_back(*ptr, Instruction::FAIL, Instruction::FAIL, Instruction::NO_BINDING);
+			instruction.item.next = nullptr;
+			dependencies |= ClassifyDependencies(*ptr);
+			if (ptr->data.functionData.function.get() == RE::FUNCTION_DATA::FunctionID::kGetVMQuestVariable) {
+				const auto quest = std::bit_cast<RE::TESQuest*>(ptr->data.functionData.params[0]);
+				const auto scriptVar = std::bit_cast<RE::BSString*>(ptr->data.functionData.params[1]);
+				instruction.binding = static_cast<uint16_t>(bindings.size());
+				bindings.emplace_back(quest, scriptVar ? scriptVar->c_str() : "");
+			}
+		}
+		if (program.size() >= Instruction::FAIL) {
+			throw std::runtime_error("Too many conditions");
+		}
+		// An OR run spans all consecutive items flagged as OR plus the item following them
+		for (size_t begin = 0; begin < program.size();) {
+			size_t end = begin;
+			while (end < program.size() && program[end].item.data.flags.isOR) {
+				end++;
+			}
+			end = std::min(end + 1, program.size());
+			for (size_t i = begin; i < end; i++) {
+				program[i].onTrue = static_cast<uint16_t>(end);
+				program[i].onFalse = i + 1 < end ? static_cast<uint16_t>(i + 1) : Instruction::FAIL;
+			}
+			begin = end;
+		}
+	}
+
+	ConditionProgram::QuestVariableBinding::QuestVariableBinding(RE::TESQuest* a_quest, std::string_view a_scriptVariable) :
+		quest(a_quest)
+	{
+		const auto splits = Util::StringSplit(a_scriptVariable, "::");
+		if (splits.size() < 2) {
+			logger::error("GetVMQuestVariable: Invalid script variable format: {}. Expected format: <script>::<variable>", a_scriptVariable);
+			return;
+		} else if (!quest) {
+			logger::error("GetVMQuestVariable: Missing quest for script variable: {}", a_scriptVariable);
+			return;
+		}
+		auto variable = splits[1];
+		if (variable.ends_with("_var")) {
+			variable.remove_suffix(4);
+		}
+		script = splits[0];
+		property = variable;
+		valid = true;
+	}
+
+	void ConditionProgram::ReleaseBindings() const
+	{
+		for (auto& binding : bindings) {
+			binding.object = nullptr;
+			binding.value.reset();
+		}
+	}
+
+	std::optional<float> ConditionProgram::QuestVariableBinding::GetValue() const
+	{
+		if (!valid) {
+			return std::nullopt;
+		}
+		const auto epoch = bindingEpoch.load(std::memory_order_relaxed);
+		const auto snapshot = snapshotValues.load(std::memory_order_relaxed);
+		const auto time = RE::GetDurationOfApplicationRunTime();
+		if (snapshot && valueEpoch == epoch && valueTime == time) {
+			return value;
+		}
+		if (objectEpoch != epoch || !object) {
+			object = Script::GetScriptObject(quest, script.c_str());
+			objectEpoch = epoch;
+			if (!object) {
+				logger::error("GetVMQuestVariable: Failed to get script object: {} from quest: {}", script, quest->GetFormID());
+			}
+		}
+		value = object ? Script::GetTrivialPropertySave<float>(object, property) : std::nullopt;
+		if (object && !value) {
+			logger::error("GetVMQuestVariable: Failed to get property: {} from script object: {} from quest: {}", property.c_str(), script, quest->GetFormID());
+		}
+		valueEpoch = epoch;
+		valueTime = time;
+		return value;
+	}
+
+	uint8_t ConditionProgram::ClassifyDependencies(const RE::TESConditionItem& a_item)
+	{
+		using FunctionID = RE::FUNCTION_DATA::FunctionID;
+		using RunOn = RE::CONDITIONITEMOBJECT;
+		uint8_t ret = a_item.data.flags.global ? kPolled : kNone;
+		switch (a_item.data.functionData.function.get()) {
+		case FunctionID::kGetIsID:
+		case FunctionID::kGetIsClass:
+			// Fixed for the subject, other objects may be different references every time
+			return a_item.data.object == RunOn::kSelf ? ret : ret | kPolled;
+		case FunctionID::kGetIsRace:
+		case FunctionID::kGetIsSex:
+		case FunctionID::kGetIsVoiceType:
+		case FunctionID::kGetIsPlayableRace:
+		case FunctionID::kIsChild:
+			// Werewolves, vampire lords and the player in character creation change race or sex at runtime
+			return a_item.data.object == RunOn::kSelf ? ret | kRace : ret | kRace | kPolled;
+		case FunctionID::kGetStage:
+		case FunctionID::kGetStageDone:
+		case FunctionID::kGetQuestRunning:
+		case FunctionID::kGetQuestCompleted:
+			return ret | kQuest;
+		case FunctionID::kGetEquipped:
+		case FunctionID::kWornHasKeyword:
+			return ret | kEquipment;
+		default:
+			return ret | kPolled;
+		}
+	}
+
+	bool ConditionProgram::IsTrue(const Instruction& a_instruction, RE::ConditionCheckParams& a_params) const
+	{
+		// depending on type use custom logic instead
+		const auto& item = a_instruction.item;
+		if (a_instruction.binding == Instruction::NO_BINDING) {
+			return item.IsTrue(a_params);
+		}
+		const auto value = bindings[a_instruction.binding].GetValue();
+		if (!value) {
+			return false;
+		}
+		const auto comparand = item.data.flags.global ? item.data.comparisonValue.g->value : item.data.comparisonValue.f;
+		switch (item.data.flags.opCode) {
+		case RE::CONDITION_ITEM_DATA::OpCode::kEqualTo:
+			return *value == comparand;
+		case RE::CONDITION_ITEM_DATA::OpCode::kNotEqualTo:
+			return *value != comparand;
+		case RE::CONDITION_ITEM_DATA::OpCode::kGreaterThan:
+			return *value > comparand;
+		case RE::CONDITION_ITEM_DATA::OpCode::kGreaterThanOrEqualTo:
+			return *value >= comparand;
+		case RE::CONDITION_ITEM_DATA::OpCode::kLessThan:
+			return *value < comparand;
+		case RE::CONDITION_ITEM_DATA::OpCode::kLessThanOrEqualTo:
+			return *value <= comparand;
+		default:
+			return false;
+		}
+	}
+
+}  // namespace DBD
@@ -0,0 +1,102 @@
+#pragma once
+
+#include "shared/KrisV/Conditions/ConditionParser.h"
+#include "shared/KrisV/Conditions/RefMap.h"
+#include "shared/KrisV/Script.h"
+
+namespace DBD
+{
+	/// @brief Configuration conditions compiled into a flat program
+	/// Items jump directly to the next item to evaluate depending on their result, GetVMQuestVariable is resolved at
+	/// parse time and the game state the result depends on is tracked to allow caching it
+	class ConditionProgram final
+	{
+	public:
+		/// @brief Game state the result of a condition list depends on, besides the identity of its subject and target
+		enum Dependency : uint8_t
+		{
+			kNone = 0,
+			kQuest = 1 << 0,      // Quest stages and running state, tracked through quest events
+			kEquipment = 1 << 1,  // Worn items, tracked through equip events
+			kPolled = 1 << 2,     // State without any event (actor values, factions, globals, quest variables, ...), valid for one millisecond
+			kRace = 1 << 3,       // Race and sex, tracked through race switches and the character creation menu closing
+		};
+
+	public:
+		ConditionProgram() = default;
+		ConditionProgram(const std::vector<std::string>& a_rawConditions, const Conditions::RefMap& a_refMap);
+		~ConditionProgram() = default;
+
+		bool ConditionsMet(RE::TESObjectREFR* a_subject, RE::TESObjectREFR* a_target) const;
+
+		operator bool() const { return conditions != nullptr; }
+		size_t GetNumConditions() const { return program.size(); }
+		uint8_t GetDependencies() const { return dependencies; }
+		/// @brief Changes whenever any game state the conditions depend on may have changed
+		/// A result evaluated with the same subject and target remains valid as long as the stamp does not change
+		uint64_t GetStamp() const;
+
+		/// @brief Drop all cached script objects, to be called whenever a game is loaded
+		static void InvalidateBindings() { bindingEpoch.fetch_add(1, std::memory_order_relaxed); }
+		/// @brief Release the script objects cached by this program, to be called before the VM is reset for a load
+		void ReleaseBindings() const;
+		/// @brief If enabled, quest variables are only read once per millisecond instead of once per evaluation
+		static void SetQuestVariableSnapshot(bool a_enable) { snapshotValues.store(a_enable, std::memory_order_relaxed); }
+		/// @brief Register the event sinks invalidating quest, equipment and race dependencies, to be called once data is loaded
+		static void RegisterEventSinks();
+
+	private:
+		// GetVMQuestVariable resolved at parse time. The script object is looked up lazily and cached until the next game load
+		struct QuestVariableBinding
+		{
+			QuestVariableBinding(RE::TESQuest* a_quest, std::string_view a_scriptVariable);
+			~QuestVariableBinding() = default;
+
+			std::optional<float> GetValue() const;
+
+			RE::TESQuest* quest;
+			std::string script{};
+			RE::BSFixedString property{};
+			bool valid{ false };
+
+			mutable Script::ObjectPtr object{ nullptr };
+			mutable uint32_t objectEpoch{ 0 };
+			mutable std::optional<float> value{};
+			mutable uint32_t valueEpoch{ 0 };
+			mutable uint32_t valueTime{ 0 };  // Application run time in milliseconds the value was read at
+		};
+
+		// The condition list compiled into a flat array, each item knowing where to continue depending on its result
+		// An OR run continues with the next item of the run on failure and jumps past the run on success
+		struct Instruction
+		{
+			static constexpr uint16_t FAIL{ std::numeric_limits<uint16_t>::max() };
+			static constexpr uint16_t NO_BINDING{ std::numeric_limits<uint16_t>::max() };
+
+			RE::TESConditionItem item;
+			uint16_t onTrue;
+			uint16_t onFalse;
+			uint16_t binding;
+		};
+
+		struct EventTracker;
+
+		void Compile();
+		bool IsTrue(const Instruction& a_instruction, RE::ConditionCheckParams& a_params) const;
+		static uint8_t ClassifyDependencies(const RE::TESConditionItem& a_item);
+
+	private:
+		static inline std::atomic<uint32_t> bindingEpoch{ 1 };
+		static inline std::atomic<uint32_t> questEpoch{ 0 };
+		static inline std::atomic<uint32_t> equipmentEpoch{ 0 };
+		static inline std::atomic<uint32_t> raceEpoch{ 0 };
+		static inline std::atomic<bool> snapshotValues{ false };
+
+		// Owner of the parsed items, the program only holds copies of them
+		std::shared_ptr<RE::TESCondition> conditions{ nullptr };
+		std::vector<Instruction> program{};
+		std::vector<QuestVariableBinding> bindings{};
+		uint8_t dependencies{ kNone };
+	};
+
+}  // namespace DBD
@@ -0,0 +1,295 @@
+#include "Configuration.h"
+
+#include <yaml-cpp/yaml.h>
+
+#include "DBD/ApplicabilityCache.h"
+#include "DBD/Distribution.h"
+#include "shared/KrisV/Util/FormLookup.h"
+
+namespace DBD
+{
+	ConfigurationData::ConfigurationData(const fs::path& a_file)
+	{
+		const auto root = YAML::LoadFile(a_file.string());
+		const auto targetNode = root["Target"];
+		const auto sliderNode = root["Sliders"];
+		const auto textureNode = root["Textures"];
+		if (!targetNode) {
+			throw std::runtime_error("Target is not defined in configuration");
+		} else if (!sliderNode && !textureNode) {
+			throw std::runtime_error("At least one slider or texture must be defined in configuration");
+		}
+		auto parseFormList = [&](const YAML::Node& node, std::vector<std::string>& out) {
+			if (node && !isWildcardConfig) {
+				for (const auto& val : node) {
+					auto formStr = val.as<std::string>();
+					if (formStr == "*") {
+						out.clear();
+						isWildcardConfig = true;
+						return;
+					}
+					out.push_back(std::move(formStr));
+				}
+			}
+		};
+		parseFormList(targetNode["Reference"], references);
+		parseFormList(targetNode["ActorBase"], actorBases);
+		parseFormList(targetNode["Keyword"], keywords);
+		parseFormList(targetNode["Faction"], factions);
+		parseFormList(targetNode["Race"], races);
+		if (const auto conditionNode = targetNode["Conditions"]) {
+			conditions = conditionNode.as<std::vector<std::string>>(std::vector<std::string>{});
+			refMap = root["RefMap"].as<std::map<std::string, std::string>>(std::map<std::string, std::string>{});
+		}
+		for (size_t i = 0; i < ProfileType::Total; i++) {
+			const auto indexKey = magic_enum::enum_name(static_cast<ProfileType>(i));
+			const auto profileNode = root[indexKey.data()];
+			if (!profileNode.IsDefined() || !profileNode.IsSequence()) {
+				continue;
+			}
+			for (const auto& val : profileNode) {
+				// Either a plain profile name or a map of the form { name: <profile>, weight: <weight> }
+				if (val.IsMap()) {
+					const auto weight = val["weight"].as<float>(1.0f);
+					if (weight < 0.0f) {
+						throw std::runtime_error(std::format("Negative weight for profile '{}'", val["name"].as<std::string>()));
+					}
+					profiles[i].emplace_back(val["name"].as<std::string>(), weight);
+				} else {
+					profiles[i].emplace_back(val.as<std::string>(), 1.0f);
+				}
+			}
+		}
+	}
+
+	Configuration::Configuration(const ConfigurationData& a_data, const Distribution* a_distribution) :
+		isWildcardConfig(a_data.isWildcardConfig)
+	{
+		auto resolveFormList = [&]<class T>(const std::vector<std::string>& in, std::vector<T>& out) {
+			for (const auto& formStr : in) {
+				T form;
+				if constexpr (std::is_same_v<T, RE::FormID>) {
+					form = Util::FormFromString(formStr);
+				} else {
+					form = Util::FormFromString<T>(formStr);
+				}
+				if (form) {
+					out.push_back(form);
+				} else {
+					logger::warn("Invalid form ID: {}", formStr);
+				}
+			}
+		};
+		resolveFormList(a_data.references, references);
+		resolveFormList(a_data.actorBases, actorBases);
+		resolveFormList(a_data.keywords, keywords);
+		resolveFormList(a_data.factions, factions);
+		resolveFormList(a_data.races, races);
+		if (!a_data.conditions.empty()) {
+			conditions = ConditionProgram{ a_data.conditions, a_data.refMap };
+		}
+		// Identity and race checks are plain comparisons, group checks have to look through the actors factions and keywords
+		// and game conditions call into the game's condition functions for each item
+		targetCost = 1.0f + references.size() + actorBases.size() + races.size() + 4.0f * (factions.size() + keywords.size());
+		conditionCost = 16.0f * conditions.GetNumConditions();
+		for (size_t i = 0; i < ProfileType::Total; i++) {
+			const auto profileIdx = static_cast<ProfileType>(i);
+			std::vector<std::shared_ptr<const ProfileBase>> dest;
+			std::vector<float> destWeights;
+			for (const auto& [valStr, weight] : a_data.profiles[i]) {
+				if (valStr == "*") {
+					// TODO: Wildcard should include all public ones, but still enable usage of private profiles
+					dest.clear();
+					destWeights.clear();
+					a_distribution->ForEachProfile([&](std::shared_ptr<const ProfileBase> profil) {
+						dest.push_back(profil);
+						destWeights.push_back(weight);
+					},
+						profileIdx);
+				} else {
+					const auto& profile = a_distribution->GetProfile(valStr, profileIdx);
+					if (profile) {
+						dest.push_back(profile);
+						destWeights.push_back(weight);
+					} else {
+						logger::warn("Profile '{}' not found in any profile", valStr);
+					}
+				}
+			}
+			// Split by sex, so sampling only ever sees profiles which can apply to the actor's sex
+			for (size_t n = 0; n < dest.size(); n++) {
+				const auto sex = dest[n]->GetSex();
+				for (size_t k = 0; k < RE::SEX::kTotal; k++) {
+					if (sex != RE::SEX::kNone && sex != static_cast<RE::SEX>(k)) {
+						continue;
+					}
+					auto& pool = pools[i][k];
+					pool.profiles.push_back(dest[n]);
+					pool.weights.push_back(destWeights[n]);
+					pool.npcRacesOnly &= dest[n]->RequiresNPCRace();
+				}
+			}
+			for (auto& pool : pools[i]) {
+				pool.sampler = AliasTable{ pool.weights };
+			}
+		}
+	}
+
+	std::shared_ptr<const ProfileBase> Configuration::SelectProfile(RE::Actor* a_target, ProfileType a_type, CounterEngine& a_engine) const
+	{
+		// Picks an applicable profile with a probability proportional to its weight
+		// Usually most profiles are applicable, so a few draws from the alias table are enough. Rejected draws do not
+		// change the distribution, as every draw is independent
+		const auto base = a_target->GetActorBase();
+		const auto sex = base && base->GetSex() == RE::SEX::kFemale ? RE::SEX::kFemale : RE::SEX::kMale;
+		const auto& pool = pools[a_type][sex];
+		if (pool.sampler.empty()) {
+			return nullptr;
+		} else if (pool.npcRacesOnly) {
+			const auto race = a_target->GetRace();
+			if (!race || !race->HasKeywordString("ActorTypeNPC")) {
+				return nullptr;
+			}
+		}
+		const auto& profileList = pool.profiles;
+		for (size_t attempt = 0; attempt < std::min(MAX_SAMPLE_ATTEMPTS, profileList.size()); attempt++) {
+			const auto& profile = profileList[pool.sampler.Draw(a_engine)];
+			if (ApplicabilityCache::IsApplicable(profile.get(), a_target)) {
+				return profile;
+			}
+		}
+		// Weighted reservoir sampling over the remaining applicable profiles
+		const auto& weightList = pool.weights;
+		std::shared_ptr<const ProfileBase> ret{ nullptr };
+		float total = 0.0f;
+		for (size_t i = 0; i < profileList.size(); i++) {
+			if (weightList[i] <= 0.0f || !ApplicabilityCache::IsApplicable(profileList[i].get(), a_target)) {
+				continue;
+			}
+			total += weightList[i];
+			if (std::uniform_real_distribution<float>{ 0.0f, total }(a_engine) < weightList[i]) {
+				ret = profileList[i];
+			}
+		}
+		return ret;
+	}
+
+	Configuration::MatchPriority Configuration::GetMatchPriority(RE::Actor* a_target) const
+	{
+		return GetMatchPriority(a_target, GetSharedPriority(a_target));
+	}
+
+	Configuration::MatchPriority Configuration::GetMatchPriority(RE::Actor* a_target, MatchPriority a_sharedPriority) const
+	{
+		if (!conditions) {
+			return GetTargetPriority(a_target, a_sharedPriority);
+		}
+		// Both stages have to pass, so start with the one that is expected to reject the config for the least cost
+		// The result is the same in either order
+		const auto targetRejectionRate = MatchStatistics::GetRejectionRate(statistics.targetChecks, statistics.targetRejections);
+		const auto conditionRejectionRate = MatchStatistics::GetRejectionRate(statistics.conditionChecks, statistics.conditionRejections);
+		if (conditionCost * targetRejectionRate < targetCost * conditionRejectionRate) {
+			if (!ConditionsMet(a_target)) {
+				return MatchPriority::None;
+			}
+			return GetTargetPriority(a_target, a_sharedPriority);
+		}
+		const auto priority = GetTargetPriority(a_target, a_sharedPriority);
+		if (priority == MatchPriority::None || !ConditionsMet(a_target)) {
+			return MatchPriority::None;
+		}
+		return priority;
+	}
+
+	Configuration::MatchPriority Configuration::GetSharedPriority(RE::Actor* a_target) const
+	{
+		if (isWildcardConfig) {
+			return MatchPriority::Wildcard;
+		}
+		const auto npc = a_target->GetActorBase();
+		const auto npcId = npc ? npc->GetFormID() : RE::FormID{ 0 };
+		if (std::ranges::contains(actorBases, npcId)) {
+			return MatchPriority::ActorBase;
+		} else if (std::ranges::any_of(factions, [&](RE::TESFaction* faction) { return a_target->IsInFaction(faction); }) ||
+				   a_target->HasKeywordInArray(keywords, false)) {
+			return MatchPriority::Group;
+		} else if (npc && std::ranges::any_of(races, [&](RE::TESRace* race) { return race == npc->GetRace(); })) {
+			return MatchPriority::Race;
+		}
+		return MatchPriority::None;
+	}
+
+	Configuration::MatchPriority Configuration::GetActorPriority(RE::Actor* a_target) const
+	{
+		if (isWildcardConfig) {
+			return MatchPriority::None;
+		} else if (std::ranges::contains(references, a_target->formID)) {
+			return MatchPriority::Reference;
+		}
+		return MatchPriority::None;
+	}
+
+	Configuration::MatchPriority Configuration::GetTargetPriority(RE::Actor* a_target, MatchPriority a_sharedPriority) const
+	{
+		const auto priority = std::min(a_sharedPriority, GetActorPriority(a_target));
+		statistics.Record(statistics.targetChecks, statistics.targetRejections, priority == MatchPriority::None);
+		return priority;
+	}
+
+	bool Configuration::ConditionsMet(RE::Actor* a_target) const
+	{
+		// Repeated 3D resets would otherwise evaluate the same conditions over and over again
+		// Polled conditions change their stamp every millisecond, caching their results would never pay off
+		bool result;
+		if (conditions.GetDependencies() & ConditionProgram::kPolled) {
+			result = conditions.ConditionsMet(a_target, RE::PlayerCharacter::GetSingleton());
+		} else {
+			if (conditionResults.size() >= MAX_CONDITION_RESULTS && !conditionResults.contains(a_target->formID)) {
+				conditionResults.clear();
+			}
+			const auto stamp = conditions.GetStamp();
+			auto& [resultStamp, cachedResult] = conditionResults[a_target->formID];
+			if (resultStamp != stamp) {
+				cachedResult = conditions.ConditionsMet(a_target, RE::PlayerCharacter::GetSingleton());
+				resultStamp = stamp;
+			}
+			result = cachedResult;
+		}
+		statistics.Record(statistics.conditionChecks, statistics.conditionRejections, !result);
+		return result;
+	}
+
+	void Configuration::ResetConditions() const
+	{
+		conditionResults.clear();
+		conditions.ReleaseBindings();
+	}
+
+	Configuration::MatchStatistics::MatchStatistics(const MatchStatistics& a_other) :
+		targetChecks(a_other.targetChecks.load(std::memory_order_relaxed)),
+		targetRejections(a_other.targetRejections.load(std::memory_order_relaxed)),
+		conditionChecks(a_other.conditionChecks.load(std::memory_order_relaxed)),
+		conditionRejections(a_other.conditionRejections.load(std::memory_order_relaxed))
+	{}
+
+	void Configuration::MatchStatistics::Record(std::atomic<uint32_t>& a_checks, std::atomic<uint32_t>& a_rejections, bool a_rejected)
+	{
+		if (a_rejected) {
+			a_rejections.fetch_add(1, std::memory_order_relaxed);
+		}
+		// Halve the counts every now and then to follow changes in the game state rather than the average since startup
+		if (a_checks.fetch_add(1, std::memory_order_relaxed) + 1 >= DECAY_THRESHOLD) {
+			a_checks.store(DECAY_THRESHOLD / 2, std::memory_order_relaxed);
+			a_rejections.store(a_rejections.load(std::memory_order_relaxed) / 2, std::memory_order_relaxed);
+		}
+	}
+
+	float Configuration::MatchStatistics::GetRejectionRate(const std::atomic<uint32_t>& a_checks, const std::atomic<uint32_t>& a_rejections)
+	{
+		// Laplace smoothing, so a stage without any samples yet counts as rejecting half of the time
+		const auto checks = a_checks.load(std::memory_order_relaxed);
+		const auto rejections = a_rejections.load(std::memory_order_relaxed);
+		return (rejections + 1.0f) / (checks + 2.0f);
+	}
+
+}  // namespace DBD
@@ -0,0 +1,109 @@
+#pragma once
+
+#include "ConditionProgram.h"
+#include "ProfileBase.h"
+#include "Sampling.h"
+
+namespace DBD
+{
+	class Distribution;
+
+	/// @brief Game independent content of a configuration file, safe to create from any thread
+	struct ConfigurationData
+	{
+		ConfigurationData(const fs::path& a_file);
+		~ConfigurationData() = default;
+
+		bool isWildcardConfig{ false };
+		std::vector<std::string> references{};
+		std::vector<std::string> actorBases{};
+		std::vector<std::string> keywords{};
+		std::vector<std::string> factions{};
+		std::vector<std::string> races{};
+		std::vector<std::string> conditions{};
+		std::map<std::string, std::string> refMap{};
+		ProfileArray<std::vector<std::pair<std::string, float>>> profiles{};
+	};
+
+	struct Configuration
+	{
+		// Number of draws from the alias table before falling back to a full pass over the profiles
+		static constexpr size_t MAX_SAMPLE_ATTEMPTS{ 8 };
+		// Number of actors whose condition results are kept before the cache is cleared
+		static constexpr size_t MAX_CONDITION_RESULTS{ 1024 };
+
+		enum MatchPriority
+		{
+			Reference,
+			ActorBase,
+			Group,
+			Race,
+			Wildcard,
+			None
+		};
+
+		/// @brief Runtime rejection counts of the two stages of GetMatchPriority, used to order them by expected cost
+		struct MatchStatistics
+		{
+			static constexpr uint32_t DECAY_THRESHOLD{ 4096 };
+
+			MatchStatistics() = default;
+			MatchStatistics(const MatchStatistics& a_other);
+			~MatchStatistics() = default;
+
+			void Record(std::atomic<uint32_t>& a_checks, std::atomic<uint32_t>& a_rejections, bool a_rejected);
+			static float GetRejectionRate(const std::atomic<uint32_t>& a_checks, const std::atomic<uint32_t>& a_rejections);
+
+			std::atomic<uint32_t> targetChecks{ 0 };
+			std::atomic<uint32_t> targetRejections{ 0 };
+			std::atomic<uint32_t> conditionChecks{ 0 };
+			std::atomic<uint32_t> conditionRejections{ 0 };
+		};
+
+		/// @brief Profiles of one type compatible with actors of one sex, along with their weights
+		struct ProfilePool
+		{
+			std::vector<std::shared_ptr<const ProfileBase>> profiles;
+			std::vector<float> weights;
+			AliasTable sampler;
+			bool npcRacesOnly{ true };  // No profile in the pool applies to races without the ActorTypeNPC keyword
+		};
+
+		Configuration(const ConfigurationData& a_data, const Distribution* a_distribution);
+		~Configuration() = default;
+
+		std::shared_ptr<const ProfileBase> SelectProfile(RE::Actor* a_target, ProfileType a_type, CounterEngine& a_engine) const;
+		MatchPriority GetMatchPriority(RE::Actor* a_target) const;
+		/// @brief Same as above, with the result of GetSharedPriority already evaluated for the actor
+		MatchPriority GetMatchPriority(RE::Actor* a_target, MatchPriority a_sharedPriority) const;
+		/// @brief Priority from all targets except references (actor base, race, factions, keywords)
+		/// The result is the same for every actor sharing base, race, factions and keywords
+		MatchPriority GetSharedPriority(RE::Actor* a_target) const;
+		/// @brief Priority from targets of the individual actor (references)
+		MatchPriority GetActorPriority(RE::Actor* a_target) const;
+		/// @brief If the config needs to be evaluated for every actor, rather than once for all actors sharing a signature
+		bool IsActorSpecific() const { return !references.empty() || conditions; }
+		MatchPriority GetTargetPriority(RE::Actor* a_target, MatchPriority a_sharedPriority) const;
+		bool ConditionsMet(RE::Actor* a_target) const;
+		/// @brief Drop condition results and script objects cached for the current game
+		void ResetConditions() const;
+
+		ProfileArray<std::array<ProfilePool, RE::SEX::kTotal>> pools;
+		bool isWildcardConfig{ false };
+		std::vector<RE::FormID> references{};
+		std::vector<RE::FormID> actorBases{};
+		std::vector<RE::BGSKeyword*> keywords{};
+		std::vector<RE::TESFaction*> factions{};
+		std::vector<RE::TESRace*> races{};
+		ConditionProgram conditions{};
+
+		// Estimated relative cost of evaluating the target and condition stage
+		float targetCost{ 0.0f };
+		float conditionCost{ 0.0f };
+		mutable MatchStatistics statistics{};
+		// Last condition result per actor and the stamp of the conditions it was evaluated with, unused for polled conditions
+		// Main thread only
+		mutable std::unordered_map<RE::FormID, std::pair<uint64_t, bool>> conditionResults{};
+	};
+
+}  // namespace DBD
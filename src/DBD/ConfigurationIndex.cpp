@@ -0,0 +1,133 @@
+#include "ConfigurationIndex.h"
+
+namespace DBD
+{
+	void ConfigurationIndex::Build(const std::vector<Configuration>& a_configurations)
+	{
+		Clear();
+		Bucket<RE::TESFaction*> factionBuckets{};
+		Bucket<RE::BGSKeyword*> keywordBuckets{};
+		for (uint32_t i = 0; i < a_configurations.size(); i++) {
+			const auto& config = a_configurations[i];
+			if (config.isWildcardConfig) {
+				wildcards.push_back(i);
+				continue;
+			}
+			// Configurations listing the same target multiple times are only added once, see std::ranges::unique below
+			for (const auto& formID : config.references) references[formID].push_back(i);
+			for (const auto& formID : config.actorBases) actorBases[formID].push_back(i);
+			for (const auto& race : config.races) races[race].push_back(i);
+			for (const auto& faction : config.factions) factionBuckets[faction].push_back(i);
+			for (const auto& keyword : config.keywords) keywordBuckets[keyword].push_back(i);
+		}
+		const auto dedupe = [](auto& a_bucket) {
+			for (auto& [key, indices] : a_bucket) {
+				const auto [first, last] = std::ranges::unique(indices);
+				indices.erase(first, last);
+			}
+		};
+		dedupe(references);
+		dedupe(actorBases);
+		dedupe(races);
+		dedupe(factionBuckets);
+		dedupe(keywordBuckets);
+		factions.assign(std::make_move_iterator(factionBuckets.begin()), std::make_move_iterator(factionBuckets.end()));
+		keywords.assign(std::make_move_iterator(keywordBuckets.begin()), std::make_move_iterator(keywordBuckets.end()));
+		logger::info("Indexed {} ConfigDatas: {} references, {} actor bases, {} factions, {} keywords, {} races, {} wildcards",
+			a_configurations.size(), references.size(), actorBases.size(), factions.size(), keywords.size(), races.size(), wildcards.size());
+	}
+
+	void ConfigurationIndex::Clear()
+	{
+		references.clear();
+		actorBases.clear();
+		races.clear();
+		factions.clear();
+		keywords.clear();
+		wildcards.clear();
+	}
+
+	ConfigurationIndex::Signature ConfigurationIndex::GetSignature(RE::Actor* a_target) const
+	{
+		const auto npc = a_target->GetActorBase();
+		const auto baseID = npc && actorBases.contains(npc->GetFormID()) ? npc->GetFormID() : RE::FormID{ 0 };
+		Signature ret{ baseID, npc ? npc->GetRace() : nullptr, std::vector<uint64_t>((factions.size() + 63) / 64), std::vector<uint64_t>((keywords.size() + 63) / 64) };
+		for (size_t i = 0; i < factions.size(); i++) {
+			if (a_target->IsInFaction(factions[i].first)) {
+				ret.factionBits[i / 64] |= uint64_t{ 1 } << (i % 64);
+			}
+		}
+		for (size_t i = 0; i < keywords.size(); i++) {
+			if (a_target->HasKeyword(keywords[i].first)) {
+				ret.keywordBits[i / 64] |= uint64_t{ 1 } << (i % 64);
+			}
+		}
+		return ret;
+	}
+
+	void ConfigurationIndex::GetSharedCandidates(const Signature& a_signature, std::vector<uint32_t>& a_out) const
+	{
+		const auto isSet = [](const std::vector<uint64_t>& a_bits, size_t a_idx) {
+			return (a_bits[a_idx / 64] & (uint64_t{ 1 } << (a_idx % 64))) != 0;
+		};
+		a_out.clear();
+		a_out.insert(a_out.end(), wildcards.begin(), wildcards.end());
+		if (a_signature.base) {
+			Lookup(actorBases, a_signature.base, a_out);
+		}
+		if (a_signature.race) {
+			Lookup(races, a_signature.race, a_out);
+		}
+		for (size_t i = 0; i < factions.size(); i++) {
+			if (isSet(a_signature.factionBits, i)) {
+				a_out.insert(a_out.end(), factions[i].second.begin(), factions[i].second.end());
+			}
+		}
+		for (size_t i = 0; i < keywords.size(); i++) {
+			if (isSet(a_signature.keywordBits, i)) {
+				a_out.insert(a_out.end(), keywords[i].second.begin(), keywords[i].second.end());
+			}
+		}
+		Normalize(a_out);
+	}
+
+	void ConfigurationIndex::GetActorCandidates(RE::Actor* a_target, std::vector<uint32_t>& a_out) const
+	{
+		a_out.clear();
+		Lookup(references, a_target->formID, a_out);
+	}
+
+	size_t ConfigurationIndex::SignatureHash::operator()(const Signature& a_signature) const
+	{
+		size_t ret = 0;
+		const auto combine = [&](size_t a_value) {
+			ret ^= a_value + 0x9e3779b9 + (ret << 6) + (ret >> 2);
+		};
+		combine(std::hash<RE::FormID>{}(a_signature.base));
+		combine(std::hash<const void*>{}(a_signature.race));
+		for (const auto bits : a_signature.factionBits) combine(std::hash<uint64_t>{}(bits));
+		for (const auto bits : a_signature.keywordBits) combine(std::hash<uint64_t>{}(bits));
+		return ret;
+	}
+
+	void ConfigurationIndex::Merge(std::vector<uint32_t>& a_inOut, const std::vector<uint32_t>& a_other)
+	{
+		if (a_other.empty()) {
+			return;
+		}
+		const auto mid = a_inOut.size();
+		a_inOut.insert(a_inOut.end(), a_other.begin(), a_other.end());
+		std::inplace_merge(a_inOut.begin(), a_inOut.begin() + mid, a_inOut.end());
+		const auto [first, last] = std::ranges::unique(a_inOut);
+		a_inOut.erase(first, last);
+	}
+
+	void ConfigurationIndex::Normalize(std::vector<uint32_t>& a_inOut)
+	{
+		// Preserve the order of the configurations, a config may be found through multiple of its targets
+		std::ranges::sort(a_inOut);
+		const auto [first, last] = std::ranges::unique(a_inOut);
+		a_inOut.erase(first, last);
+	}
+
+}  // namespace DBD
@@ -0,0 +1,69 @@
+#pragma once
+
+#include "Configuration.h"
+
+namespace DBD
+{
+	/// @brief Inverted index from the targets of a configuration to the configurations targeting them
+	/// Used to only test configurations against an actor which can possibly match it
+	class ConfigurationIndex
+	{
+	public:
+		/// @brief Everything but the reference of an actor that configuration targets can depend on
+		/// The actor base is only stored if any configuration targets it, so leveled actors and all other untargeted bases share
+		/// their signature. Factions and keywords are stored as bitsets over the factions and keywords used by any configuration
+		struct Signature
+		{
+			RE::FormID base;
+			RE::TESRace* race;
+			std::vector<uint64_t> factionBits;
+			std::vector<uint64_t> keywordBits;
+
+			bool operator==(const Signature&) const = default;
+		};
+		struct SignatureHash
+		{
+			size_t operator()(const Signature& a_signature) const;
+		};
+
+	public:
+		ConfigurationIndex() = default;
+		~ConfigurationIndex() = default;
+
+		void Build(const std::vector<Configuration>& a_configurations);
+		void Clear();
+
+		Signature GetSignature(RE::Actor* a_target) const;
+		/// @brief Collect the indices of all configurations which may match the given actor, in ascending order
+		/// Candidates through targets shared by all actors of the same signature (actor base, race, factions, keywords, wildcards)
+		void GetSharedCandidates(const Signature& a_signature, std::vector<uint32_t>& a_out) const;
+		/// @brief Candidates through targets of the individual actor (references)
+		void GetActorCandidates(RE::Actor* a_target, std::vector<uint32_t>& a_out) const;
+
+		/// @brief Merge two ascending candidate lists into the first one
+		static void Merge(std::vector<uint32_t>& a_inOut, const std::vector<uint32_t>& a_other);
+
+	private:
+		template <class K>
+		using Bucket = std::unordered_map<K, std::vector<uint32_t>>;
+
+		template <class K>
+		static void Lookup(const Bucket<K>& a_bucket, const K& a_key, std::vector<uint32_t>& a_out)
+		{
+			if (const auto it = a_bucket.find(a_key); it != a_bucket.end()) {
+				a_out.insert(a_out.end(), it->second.begin(), it->second.end());
+			}
+		}
+		static void Normalize(std::vector<uint32_t>& a_inOut);
+
+		Bucket<RE::FormID> references{};
+		Bucket<RE::FormID> actorBases{};
+		Bucket<RE::TESRace*> races{};
+		// Group membership can only be probed through the actor, hence these are stored as distinct lists
+		// The position in the list is the bit used in the signature
+		std::vector<std::pair<RE::TESFaction*, std::vector<uint32_t>>> factions{};
+		std::vector<std::pair<RE::BGSKeyword*, std::vector<uint32_t>>> keywords{};
+		std::vector<uint32_t> wildcards{};
+	};
+
+}  // namespace DBD
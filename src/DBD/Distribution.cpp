@@ -1,6 +1,8 @@
 #include "Distribution.h"
 
-#include "shared/KrisV/Util/FormLookup.h"
+#include "DBD/ApplicabilityCache.h"
+#include "DBD/Profiler.h"
+#include "DBD/Settings.h"
 #include "shared/KrisV/Random.h"
 
 namespace DBD
@@ -19,22 +21,128 @@ namespace DBD
 			logger::error("Failed to get SKEE interface map");
 		}
 
-		LoadTextureProfiles();
-		LoadSliderProfiles();
-		LoadConditions();
-
 		const auto player = RE::PlayerCharacter::GetSingleton();
 		const auto playerNPC = player->GetActorBase();
 		playerSexPreChargen = playerNPC ? playerNPC->GetSex() : RE::SEX::kMale;
+
+		if (Settings::asyncInitialize) {
+			logger::info("Loading profiles and configurations in the background");
+			std::thread([this]() {
+				const auto configurationFiles = std::make_shared<std::vector<ConfigurationFile>>(LoadData());
+				SKSE::GetTaskInterface()->AddTask([this, configurationFiles]() {
+					FinishInitialize(*configurationFiles);
+				});
+			}).detach();
+		} else {
+			FinishInitialize(LoadData());
+		}
+	}
+
+	std::vector<Distribution::ConfigurationFile> Distribution::LoadData()
+	{
+		// Both profile types are independent of each other, configurations however need to resolve their profiles by name
+		ProfileSnapshot snapshot{};
+		auto textureTask = std::async(std::launch::async, [&]() { LoadTextureProfiles(snapshot); });
+		LoadSliderProfiles(snapshot);
+		textureTask.get();
+		snapshot.Commit();
+		SliderNames::Freeze();
+		uint32_t numProfiles = 0;
+		for (auto& profiles : profileMap) {
+			for (auto& [name, profile] : profiles) {
+				profile->SetIndex(numProfiles++);
+			}
+		}
+		ApplicabilityCache::Reset(numProfiles);
+		return LoadConditions();
+	}
+
+	void Distribution::FinishInitialize(const std::vector<ConfigurationFile>& a_configurationFiles)
+	{
+		ResolveConditions(a_configurationFiles);
+		generation++;
+		ready.store(true, std::memory_order_release);
+		Profiler::Report();
+
+		std::set<RE::FormID> actors;
+		std::vector<CacheEntry> entries;
+		{
+			std::scoped_lock lock{ pendingLock };
+			actors = std::move(pendingActors);
+			entries = std::move(pendingCache);
+			pendingActors.clear();
+			pendingCache.clear();
+		}
+		ResolveCacheEntries(entries);
+		if (!actors.empty()) {
+			logger::info("Applying profiles to {} actors loaded during initialization", actors.size());
+		}
+		std::vector<RE::Actor*> targets;
+		targets.reserve(actors.size());
+		for (const auto& formID : actors) {
+			targets.push_back(RE::TESForm::LookupByID<RE::Actor>(formID));
+		}
+		ApplyProfiles(targets);
 	}
 
 	ProfileArray<std::shared_ptr<const ProfileBase>> Distribution::SelectProfiles(RE::Actor* a_target)
 	{
-		ProfileArray<std::shared_ptr<const ProfileBase>> selectedProfiles{};
-		if (excludedForms.contains(a_target->formID)) {
-			return selectedProfiles;
+		if (!IsReady() || excludedForms.contains(a_target->formID)) {
+			return {};
 		}
+		return SelectActorProfiles(a_target);
+	}
 
+	std::vector<ProfileArray<std::shared_ptr<const ProfileBase>>> Distribution::SelectProfiles(std::span<RE::Actor* const> a_targets)
+	{
+		std::vector<ProfileArray<std::shared_ptr<const ProfileBase>>> ret(a_targets.size());
+		if (!IsReady()) {
+			return ret;
+		}
+		// Actors sharing a signature are matched against all configurations that do not depend on the individual actor once
+		const auto firstSignatureId = nextSignatureId;
+		for (size_t i = 0; i < a_targets.size(); i++) {
+			const auto actor = a_targets[i];
+			if (!actor || excludedForms.contains(actor->formID)) {
+				continue;
+			}
+			ret[i] = SelectActorProfiles(actor);
+		}
+		logger::debug("Selected profiles for {} actors, {} new signatures", a_targets.size(), nextSignatureId - firstSignatureId);
+		return ret;
+	}
+
+	const Distribution::SignatureMatch& Distribution::GetSignatureMatch(RE::Actor* a_target)
+	{
+		auto signature = configurationIndex.GetSignature(a_target);
+		if (const auto it = signatureCache.find(signature); it != signatureCache.end()) {
+			return it->second;
+		}
+		if (signatureCache.size() >= MAX_SIGNATURES) {
+			logger::debug("Signature cache reached {} entries, clearing it", signatureCache.size());
+			signatureCache.clear();
+		}
+		SignatureMatch match{ nextSignatureId++ };
+		std::vector<uint32_t> candidates;
+		configurationIndex.GetSharedCandidates(signature, candidates);
+		for (const auto idx : candidates) {
+			const auto& config = configurations[idx];
+			const auto sharedPriority = config.GetSharedPriority(a_target);
+			if (config.IsActorSpecific()) {
+				match.pending.emplace_back(idx, sharedPriority);
+			} else if (sharedPriority != Configuration::MatchPriority::None) {
+				match.matches.emplace_back(idx, sharedPriority);
+			}
+		}
+		return signatureCache.emplace(std::move(signature), std::move(match)).first->second;
+	}
+
+	ProfileArray<std::shared_ptr<const ProfileBase>> Distribution::SelectActorProfiles(RE::Actor* a_target)
+	{
+		using Priority = Configuration::MatchPriority;
+		ProfileArray<std::shared_ptr<const ProfileBase>> selectedProfiles{};
+
+		bool isCached = false;
 		const auto cacheIt = cache.find(a_target->formID);
 		if (cacheIt != cache.end()) {
 			if (a_target->IsPlayerRef()) {
@@ -46,17 +154,54 @@ namespace DBD
 				}
 			}
 			selectedProfiles = cacheIt->second;
+			if (std::ranges::all_of(selectedProfiles, [](const auto& profile) { return profile != nullptr; })) {
+				return selectedProfiles;
+			}
+			isCached = true;
 		}
 
 SkipCaching:
-		using Priority = Configuration::MatchPriority;
+		// The signature is only needed once the cache cannot answer the selection on its own
+		const auto& match = GetSignatureMatch(a_target);
+		// Configs depending on the individual actor are those pending in the signature and those targeting its reference
+		std::vector<uint32_t> references;
+		configurationIndex.GetActorCandidates(a_target, references);
+		// If nothing the selection depends on changed since the remaining slots came up empty, they would stay empty
+		const auto resolveKey = GetResolveKey(references, match);
+		if (isCached) {
+			if (const auto it = resolved.find(a_target->formID); it != resolved.end() && it->second == resolveKey) {
+				return selectedProfiles;
+			}
+		}
+		std::vector<IndexedPriority> matches{ match.matches };
+		const auto numShared = matches.size();
+		auto pendingIt = match.pending.begin();
+		auto referenceIt = references.begin();
+		while (pendingIt != match.pending.end() || referenceIt != references.end()) {
+			uint32_t idx;
+			Priority sharedPriority{ Priority::None };
+			if (referenceIt == references.end() || (pendingIt != match.pending.end() && pendingIt->first <= *referenceIt)) {
+				idx = pendingIt->first;
+				sharedPriority = pendingIt->second;
+				if (referenceIt != references.end() && *referenceIt == idx) {
+					++referenceIt;
+				}
+				++pendingIt;
+			} else {
+				idx = *referenceIt++;
+			}
+			const auto tmpPriority = configurations[idx].GetMatchPriority(a_target, sharedPriority);
+			if (tmpPriority != Priority::None) {
+				matches.emplace_back(idx, tmpPriority);
+			}
+		}
+		// Keep configs in their original order, to not change the outcome of the shuffle below
+		std::inplace_merge(matches.begin(), matches.begin() + numShared, matches.end());
+
 		std::vector<const Configuration*> validConfigs;
 		Priority priority{ Priority::None };
-		for (const auto& config : configurations) {
-			const auto tmpPriority = config.GetMatchPriority(a_target);
-			if (tmpPriority == Priority::None) {
-				continue;
-			}
+		for (const auto& [idx, tmpPriority] : matches) {
+			const auto& config = configurations[idx];
 			if (tmpPriority < priority) {
 				validConfigs = { &config };
 				priority = tmpPriority;
@@ -64,12 +209,13 @@ SkipCaching:
 				validConfigs.push_back(&config);
 			}
 		}
-		Random::shuffle(validConfigs);
+		auto engine = GetEngine(a_target);
+		std::ranges::shuffle(validConfigs, engine);
 		for (size_t i = 0; i < selectedProfiles.size(); i++) {
 			if (selectedProfiles[i])
 				continue;
 			for (const auto& config : validConfigs) {
-				if (const auto& profile = config->SelectProfile(a_target, ProfileType(i))) {
+				if (const auto& profile = config->SelectProfile(a_target, ProfileType(i), engine)) {
 					selectedProfiles[i] = profile;
 					break;
 				}
@@ -77,14 +223,98 @@ SkipCaching:
 		}
 
 		cache[a_target->formID] = selectedProfiles;
+		resolved[a_target->formID] = resolveKey;
 		return selectedProfiles;
 	}
 
+	Distribution::ResolveKey Distribution::GetResolveKey(const std::vector<uint32_t>& a_references, const SignatureMatch& a_match) const
+	{
+		// Only the conditions of configs depending on the individual actor are evaluated for it, every other config is
+		// covered by the signature. References are fixed, so only their conditions can change the outcome
+		uint64_t stamp = 0;
+		const auto addStamp = [&](uint32_t a_idx) {
+			if (const auto& conditions = configurations[a_idx].conditions) {
+				stamp += conditions.GetStamp();
+			}
+		};
+		for (const auto& [idx, priority] : a_match.pending) {
+			addStamp(idx);
+		}
+		std::ranges::for_each(a_references, addStamp);
+		return ResolveKey{ generation, a_match.id, stamp };
+	}
+
+	CounterEngine Distribution::GetEngine(RE::Actor* a_target) const
+	{
+		if (!Settings::deterministicDistribution) {
+			return CounterEngine{ (static_cast<uint64_t>(Random::eng()) << 32) | Random::eng() };
+		}
+		// Identify the actor by its plugin relative id, to be independent of the load order
+		uint64_t key = a_target->GetFormID();
+		if (const auto file = a_target->GetFile(0)) {
+			key = (CaseInsensitiveHash{}(file->GetFilename()) << 24) ^ a_target->GetLocalFormID();
+		}
+		return CounterEngine{ CounterEngine::Mix(key ^ salt) };
+	}
+
+	void Distribution::ApplyProfiles(RE::Actor* a_target)
+	{
+		if (!a_target || !a_target->Is3DLoaded()) {
+			return;
+		}
+		if (!IsReady()) {
+			std::scoped_lock lock{ pendingLock };
+			if (!IsReady()) {
+				pendingActors.insert(a_target->formID);
+				return;
+			}
+		}
+
+		const auto profiles = SelectProfiles(a_target);
+		for (auto&& profile : profiles) {
+			if (profile) {
+				profile->Apply(a_target);
+			}
+		}
+	}
+
+	void Distribution::ApplyProfiles(std::span<RE::Actor* const> a_targets)
+	{
+		std::vector<RE::Actor*> targets;
+		targets.reserve(a_targets.size());
+		std::ranges::copy_if(a_targets, std::back_inserter(targets), [](RE::Actor* a_target) { return a_target && a_target->Is3DLoaded(); });
+		if (targets.empty()) {
+			return;
+		}
+		if (!IsReady()) {
+			std::scoped_lock lock{ pendingLock };
+			if (!IsReady()) {
+				for (const auto& target : targets) {
+					pendingActors.insert(target->formID);
+				}
+				return;
+			}
+		}
+
+		const auto selection = SelectProfiles(targets);
+		for (size_t i = 0; i < targets.size(); i++) {
+			for (auto&& profile : selection[i]) {
+				if (profile) {
+					profile->Apply(targets[i]);
+				}
+			}
+		}
+	}
+
 	bool Distribution::ApplyProfile(RE::Actor* a_target, const std::string& a_profileId, ProfileType a_type)
 	{
+		if (!IsReady()) {
+			return false;
+		}
 		auto it = profileMap[a_type].find(a_profileId);
-		if (it != profileMap[a_type].end() && it->second.get()->IsApplicable(a_target)) {
+		if (it != profileMap[a_type].end() && ApplicabilityCache::IsApplicable(it->second.get(), a_target)) {
 			cache[a_target->formID][a_type] = it->second;
+			pinnedForms.insert(a_target->formID);
 			excludedForms.erase(a_target->formID);
 			a_target->DoReset3D(false);
 			return true;
@@ -122,6 +352,9 @@ SkipCaching:
 
 	void Distribution::ForEachTextureProfile(const std::function<void(const TextureProfile*)>& a_callback) const
 	{
+		if (!IsReady()) {
+			return;
+		}
 		ForEachProfile([&](std::shared_ptr<const ProfileBase> profile) {
 			a_callback(static_cast<const TextureProfile*>(profile.get()));
 		},
@@ -130,6 +363,9 @@ SkipCaching:
 
 	void Distribution::ForEachSliderProfile(const std::function<void(const SliderProfile*)>& a_callback) const
 	{
+		if (!IsReady()) {
+			return;
+		}
 		ForEachProfile([&](std::shared_ptr<const ProfileBase> profile) {
 			a_callback(static_cast<const SliderProfile*>(profile.get()));
 		},
@@ -154,6 +390,8 @@ SkipCaching:
 		const auto formID = a_target->formID;
 		excludedForms.insert(formID);
 		cache.erase(formID);
+		resolved.erase(formID);
+		pinnedForms.erase(formID);
 		SliderProfile::DeleteMorphs(a_target, morphInterface);
 		a_target->DoReset3D(false);
 		if (!a_exclude) {
@@ -161,40 +399,84 @@ SkipCaching:
 		}
 	}
 
-	void Distribution::LoadTextureProfiles()
+	void Distribution::LoadTextureProfiles(ProfileSnapshot& a_snapshot)
 	{
 		logger::info("Loading Texture Sets");
+		Profiler::Scope phaseScope{ "Textures" };
 		if (!fs::exists(TEXTURE_ROOT_PATH)) {
 			logger::critical("Path to textures does not exist");
-		} else {
-			for (auto& folder : fs::directory_iterator{ TEXTURE_ROOT_PATH }) {
-				if (!folder.is_directory())
-					continue;
+			return;
+		}
+		std::vector<fs::directory_entry> folders{};
+		for (auto& folder : fs::directory_iterator{ TEXTURE_ROOT_PATH }) {
+			if (folder.is_directory())
+				folders.push_back(folder);
+		}
+		struct Result
+		{
+			std::shared_ptr<TextureProfile> profile{ nullptr };
+			std::string error{};
+		};
+		std::vector<Result> results(folders.size());
+		std::for_each(std::execution::par, folders.begin(), folders.end(), [&](const fs::directory_entry& folder) {
+			auto& result = results[&folder - folders.data()];
+			const auto key = folder.path().string();
+			Profiler::Scope fileScope{ "Textures", key };
+			if (auto reader = a_snapshot.Find(key, 0)) {
 				try {
-					auto profile = std::make_shared<TextureProfile>(folder);
-					auto name = std::string{ profile->GetName() };
-					profileMap[ProfileType::Textures][name] = std::move(profile);
-					logger::info("Added Texture Set: {}", name);
+					result.profile = std::make_shared<TextureProfile>(*reader);
+					fileScope.AddProfiles(1);
+					a_snapshot.Reuse(key);
+					return;
 				} catch (const std::exception& e) {
-					logger::error("Failed to add Texture Set: {}. Error: {}", folder.path().filename().string(), e.what());
+					logger::warn("Failed to read Texture Set from snapshot: {}. Error: {}", key, e.what());
 				}
 			}
-			logger::info("Loaded {} Texture Sets", profileMap[ProfileType::Textures].size());
+			try {
+				result.profile = std::make_shared<TextureProfile>(folder);
+				fileScope.AddProfiles(1);
+				SnapshotWriter writer{};
+				result.profile->Write(writer);
+				a_snapshot.Store(key, 0, ProfileSnapshot::MakeDirectoryManifest(folder.path()), writer.GetData());
+			} catch (const std::exception& e) {
+				result.error = e.what();
+			}
+		});
+		// Merge in enumeration order to keep replacement of duplicate names deterministic
+		for (size_t i = 0; i < results.size(); i++) {
+			auto& [profile, error] = results[i];
+			if (!profile) {
+				logger::error("Failed to add Texture Set: {}. Error: {}", folders[i].path().filename().string(), error);
+				continue;
+			}
+			auto name = std::string{ profile->GetName() };
+			profileMap[ProfileType::Textures][name] = std::move(profile);
+			logger::info("Added Texture Set: {}", name);
 		}
+		logger::info("Loaded {} Texture Sets", profileMap[ProfileType::Textures].size());
 	}
 
-	void Distribution::LoadSliderProfiles()
+	void Distribution::LoadSliderProfiles(ProfileSnapshot& a_snapshot)
 	{
 		logger::info("Loading Slider Sets");
+		Profiler::Scope phaseScope{ "Sliders" };
 		if (!morphInterface) {
 			logger::critical("Missing morph interface. Skipping slider profile initialization");
 			return;
 		}
-		SliderConfig sliderConfig{};
-		const auto parseDirectory = [&](auto& directory, auto sex) {
+		const SliderConfig sliderConfig{ a_snapshot };
+		struct Source
+		{
+			fs::path path;
+			uint64_t size;
+			RE::SEX sex;
+		};
+		std::vector<Source> sources{};
+		const auto collectDirectory = [&](const std::string& directory, RE::SEX sex) {
+			const auto begin = sources.size();
 			if (!fs::exists(directory)) {
 				logger::warn("Directory does not exist: {}", directory);
-				return;
+				return std::make_pair(begin, begin);
 			}
 			for (auto& file : fs::recursive_directory_iterator{ directory }) {
 				if (!file.is_regular_file()) {
@@ -203,37 +485,87 @@ SkipCaching:
 					logger::warn("Skipping non-XML file: {}", file.path().string());
 					continue;
 				}
-				try {
-					const auto sliderProfiles = SliderProfile::LoadProfiles(file.path(), sex, morphInterface, &sliderConfig);
-					for (const auto& profile : sliderProfiles) {
-						auto name = std::string{ profile->GetName() };
-						if (profileMap[ProfileType::Sliders].contains(name)) {
-							logger::warn("Slider Set already exists and will be replaced: {}", name);
-						}
-						profileMap[ProfileType::Sliders][name] = profile;
-						logger::info("Added Slider Set: {}", name);
-					}
-				} catch (const std::exception& e) {
-					logger::error("Failed to add Slider Set: {}. Error: {}", file.path().string(), e.what());
-				}
+				std::error_code ec;
+				sources.emplace_back(file.path(), file.file_size(ec), sex);
 			}
+			return std::make_pair(begin, sources.size());
 		};
-		parseDirectory(SLIDER_DEFAULT_PATH, RE::SEX::kNone);
+		const auto defaultRange = collectDirectory(SLIDER_DEFAULT_PATH, RE::SEX::kNone);
+		std::vector<std::pair<std::string, std::pair<size_t, size_t>>> typedRanges{};
 		for (auto& type : std::vector{ "male", "female" }) {
 			const auto rootFolder = std::format("{}/{}", SLIDER_ROOT_PATH, type);
 			const auto sex = (type == "male"s) ? RE::SEX::kMale : RE::SEX::kFemale;
-			parseDirectory(rootFolder, sex);
-			logger::info("Loaded {} Slider Sets for {}", profileMap[ProfileType::Sliders].size(), type);
+			typedRanges.emplace_back(type, collectDirectory(rootFolder, sex));
+		}
+
+		struct Result
+		{
+			std::vector<std::shared_ptr<SliderProfile>> profiles{};
+			std::string error{};
+		};
+		std::vector<Result> results(sources.size());
+		std::for_each(std::execution::par, sources.begin(), sources.end(), [&](const Source& source) {
+			auto& result = results[&source - sources.data()];
+			const auto key = source.path.string();
+			// Every preset depends on the exclusions of the slider config, those without an explicit sex also on its assignments
+			const auto tag = sliderConfig.GetHash() ^ static_cast<uint64_t>(std::to_underlying(source.sex));
+			Profiler::Scope fileScope{ "Sliders", key };
+			if (auto reader = a_snapshot.Find(key, tag)) {
+				try {
+					result.profiles = SliderProfile::LoadProfiles(*reader, morphInterface);
+					fileScope.AddProfiles(result.profiles.size());
+					a_snapshot.Reuse(key);
+					return;
+				} catch (const std::exception& e) {
+					logger::warn("Failed to read Slider Set from snapshot: {}. Error: {}", key, e.what());
+				}
+			}
+			try {
+				fileScope.AddBytes(source.size);
+				result.profiles = SliderProfile::LoadProfiles(source.path, source.sex, morphInterface, &sliderConfig);
+				fileScope.AddProfiles(result.profiles.size());
+				SnapshotWriter writer{};
+				SliderProfile::WriteProfiles(writer, result.profiles);
+				a_snapshot.Store(key, tag, ProfileSnapshot::MakeFileManifest(source.path), writer.GetData());
+			} catch (const std::exception& e) {
+				result.error = e.what();
+			}
+		});
+		// Merge in enumeration order to keep replacement of duplicate names deterministic
+		auto& sliderMap = profileMap[ProfileType::Sliders];
+		const auto mergeRange = [&](const std::pair<size_t, size_t>& range) {
+			for (size_t i = range.first; i < range.second; i++) {
+				const auto& [profiles, error] = results[i];
+				if (!error.empty()) {
+					logger::error("Failed to add Slider Set: {}. Error: {}", sources[i].path.string(), error);
+					continue;
+				}
+				for (const auto& profile : profiles) {
+					auto name = std::string{ profile->GetName() };
+					if (sliderMap.contains(name)) {
+						logger::warn("Slider Set already exists and will be replaced: {}", name);
+					}
+					sliderMap[name] = profile;
+					logger::info("Added Slider Set: {}", name);
+				}
+			}
+		};
+		mergeRange(defaultRange);
+		for (const auto& [type, range] : typedRanges) {
+			mergeRange(range);
+			logger::info("Loaded {} Slider Sets for {}", sliderMap.size(), type);
 		}
 	}
 
-	void Distribution::LoadConditions()
+	std::vector<Distribution::ConfigurationFile> Distribution::LoadConditions()
 	{
 		logger::info("Loading ConfigDatas");
+		Profiler::Scope phaseScope{ "Configurations" };
 		if (!fs::exists(CONFIGURATION_ROOT_PATH)) {
 			logger::critical("Path to ConfigDatas does not exist");
-			return;
+			return {};
 		}
+		std::vector<fs::directory_entry> files{};
 		for (auto& file : fs::directory_iterator{ CONFIGURATION_ROOT_PATH }) {
 			if (!file.is_regular_file())
 				continue;
@@ -242,25 +574,70 @@ SkipCaching:
 				logger::warn("Skipping non-YML file: {}", fileName);
 				continue;
 			}
+			files.push_back(file);
+		}
+		// Parsing the files does not touch any game data and can be done concurrently
+		std::vector<ConfigurationFile> results(files.size());
+		std::for_each(std::execution::par, files.begin(), files.end(), [&](const fs::directory_entry& file) {
+			auto& result = results[&file - files.data()];
+			result.fileName = file.path().filename().string();
+			Profiler::Scope fileScope{ "Configurations", file.path().string() };
 			try {
-				YAML::Node config = YAML::LoadFile(file.path().string());
-				configurations.emplace_back(config, this);
-			} catch (const YAML::Exception& e) {
-				logger::error("Failed to parse ConfigData file '{}': {}", fileName, e.what());
+				std::error_code ec;
+				fileScope.AddBytes(file.file_size(ec));
+				result.data.emplace(file.path());
+				fileScope.AddProfiles(1);
+			} catch (const std::exception& e) {
+				result.error = e.what();
+			}
+		});
+		return results;
+	}
+
+	void Distribution::ResolveConditions(const std::vector<ConfigurationFile>& a_configurationFiles)
+	{
+		// Resolve all forms and profiles in a single pass on the main thread
+		Profiler::Scope phaseScope{ "Resolve Configurations" };
+		configurations.reserve(a_configurationFiles.size());
+		for (const auto& [fileName, data, error] : a_configurationFiles) {
+			if (!data) {
+				logger::error("Failed to parse ConfigData file '{}': {}", fileName, error);
 				continue;
 			}
+			try {
+				configurations.emplace_back(*data, this);
+			} catch (const std::exception& e) {
+				logger::error("Failed to load ConfigData file '{}': {}", fileName, e.what());
+			}
 		}
+		logger::info("Loaded {} ConfigDatas", configurations.size());
+		configurationIndex.Build(configurations);
 	}
 
 	void Distribution::Save(SKSE::SerializationInterface* a_intfc, uint32_t)
 	{
-		std::size_t numRegs = cache.size();
+		// In deterministic mode, every entry that was not assigned manually is recreated identically on demand
+		const auto isSaved = [&](RE::FormID a_formID) {
+			return !Settings::deterministicDistribution || pinnedForms.contains(a_formID);
+		};
+		// Entries loaded during a background initialization are not resolved yet, save them as they were loaded
+		std::vector<CacheEntry> unresolved;
+		if (!IsReady()) {
+			std::scoped_lock lock{ pendingLock };
+			if (!IsReady()) {
+				unresolved = pendingCache;
+			}
+		}
+		std::erase_if(unresolved, [&](const CacheEntry& a_entry) { return cache.contains(a_entry.first); });
+		auto numRegs = static_cast<std::size_t>(std::ranges::count_if(cache, [&](const auto& entry) { return isSaved(entry.first); })) + unresolved.size();
 		if (!a_intfc->WriteRecordData(numRegs)) {
 			logger::error("Failed to save number of regs ({})", numRegs);
 			return;
 		}
 		for (auto&& [formID, data] : cache) {
-			if (!a_intfc->WriteRecordData(formID)) {
+			if (!isSaved(formID)) {
+				continue;
+			} else if (!a_intfc->WriteRecordData(formID)) {
 				logger::error("Failed to save reg ({:X})", formID);
 				continue;
 			}
@@ -272,6 +649,18 @@ SkipCaching:
 				}
 			}
 		}
+		for (const auto& [formID, names] : unresolved) {
+			if (!a_intfc->WriteRecordData(formID)) {
+				logger::error("Failed to save reg ({:X})", formID);
+				continue;
+			}
+			for (size_t i = 0; i < ProfileType::Total_V1; i++) {
+				if (!stl::write_string(a_intfc, std::string_view{ names[i].c_str() })) {
+					logger::error("Failed to save reg ({})", names[i].c_str());
+					continue;
+				}
+			}
+		}
 
 		numRegs = excludedForms.size();
 		if (!a_intfc->WriteRecordData(numRegs)) {
@@ -290,33 +679,39 @@ SkipCaching:
 	{
 		cache.clear();
 		excludedForms.clear();
+		pinnedForms.clear();
 		size_t numRegs;
 		a_intfc->ReadRecordData(numRegs);
 
 		RE::FormID formID;
-		std::string cacheValue;
+		std::vector<CacheEntry> entries;
+		entries.reserve(numRegs);
 		for (size_t i = 0; i < numRegs; i++) {
 			a_intfc->ReadRecordData(formID);
 			if (!a_intfc->ResolveFormID(formID, formID)) {
 				logger::warn("Error reading formID: {:X}", formID);
 				continue;
 			}
-			auto& cacheEntry = cache[formID];
+			pinnedForms.insert(formID);
+			auto& cacheValues = entries.emplace_back(formID, ProfileArray<std::string>{}).second;
 			// COMEBACK: If version ever gets a value != 1, update index max here
 			for (size_t n = 0; n < ProfileType::Total_V1; n++) {
-				if (!stl::read_string(a_intfc, cacheValue)) {
-					logger::error("Failed to load reg: {}", cacheValue);
+				if (!stl::read_string(a_intfc, cacheValues[n])) {
+					logger::error("Failed to load reg: {}", cacheValues[n]);
 					continue;
 				}
-				auto it = profileMap[n].find(cacheValue);
-				if (it != profileMap[n].end()) {
-					cacheEntry[n] = it->second;
-				} else if (!cacheValue.empty()) {
-					logger::error("Failed to load profile: {}", cacheValue);
-				}
 			}
 		}
-		logger::info("Loaded {} cache entries", cache.size());
+		{
+			std::scoped_lock lock{ pendingLock };
+			if (!IsReady()) {
+				// Profiles are still being loaded, resolve the entries once they are available
+				logger::info("Deferring {} cache entries until initialization finished", entries.size());
+				pendingCache = std::move(entries);
+				entries.clear();
+			}
+		}
+		ResolveCacheEntries(entries);
 
 		a_intfc->ReadRecordData(numRegs);
 		for (size_t i = 0; i < numRegs; i++) {
@@ -330,9 +725,55 @@ SkipCaching:
 		logger::info("Loaded {} excluded forms", excludedForms.size());
 	}
 
+	void Distribution::ResolveCacheEntries(const std::vector<CacheEntry>& a_entries)
+	{
+		if (a_entries.empty()) {
+			return;
+		}
+		for (const auto& [formID, cacheValues] : a_entries) {
+			auto& cacheEntry = cache[formID];
+			for (size_t n = 0; n < cacheValues.size(); n++) {
+				const auto& cacheValue = cacheValues[n];
+				auto it = profileMap[n].find(cacheValue);
+				if (it != profileMap[n].end()) {
+					cacheEntry[n] = it->second;
+				} else if (!cacheValue.empty()) {
+					logger::error("Failed to load profile: {}", cacheValue);
+				}
+			}
+		}
+		logger::info("Loaded {} cache entries", cache.size());
+	}
+
+	void Distribution::SaveSalt(SKSE::SerializationInterface* a_intfc, uint32_t)
+	{
+		if (!a_intfc->WriteRecordData(salt)) {
+			logger::error("Failed to save salt");
+		}
+	}
+
+	void Distribution::LoadSalt(SKSE::SerializationInterface* a_intfc, uint32_t)
+	{
+		if (!a_intfc->ReadRecordData(salt)) {
+			logger::error("Failed to load salt");
+		}
+	}
+
 	void Distribution::Revert(SKSE::SerializationInterface*)
 	{
 		cache.clear();
+		resolved.clear();
+		signatureCache.clear();
+		pinnedForms.clear();
+		// Script objects of the previous session must not be used by conditions evaluated while the save loads
+		ConditionProgram::InvalidateBindings();
+		for (const auto& config : configurations) {
+			config.ResetConditions();
+		}
+		// Saves without a salt record, and new games, get a fresh one
+		salt = (static_cast<uint64_t>(Random::eng()) << 32) | Random::eng();
+		std::scoped_lock lock{ pendingLock };
+		pendingCache.clear();
 	}
 
 	void Distribution::OnAttach(
@@ -360,114 +801,4 @@ SkipCaching:
 		textureProfile->OverrideObjectTextures(object);
 	}
 
-	Distribution::Configuration::Configuration(const YAML::Node& a_node, const Distribution* a_distribution)
-	{
-		const auto targetNode = a_node["Target"];
-		const auto sliderNode = a_node["Sliders"];
-		const auto textureNode = a_node["Textures"];
-		if (!targetNode) {
-			throw std::runtime_error("Target is not defined in configuration");
-		} else if (!sliderNode && !textureNode) {
-			throw std::runtime_error("At least one slider or texture must be defined in configuration");
-		}
-		auto parseFormList = [&]<class T>(const YAML::Node& node, std::vector<T>& out) {
-			if (node && !isWildcardConfig) {
-				for (const auto& val : node) {
-					auto formStr = val.as<std::string>();
-					if (formStr == "*") {
-						out.clear();
-						isWildcardConfig = true;
-						return;
-					}
-					T form;
-					if constexpr (std::is_same_v<T, RE::FormID>) {
-						form = Util::FormFromString(formStr);
-					} else {
-						form = Util::FormFromString<T>(formStr);
-					}
-					if (form) {
-						out.push_back(form);
-					} else {
-						logger::warn("Invalid form ID: {}", formStr);
-					}
-				}
-			}
-		};
-		parseFormList(targetNode["Reference"], references);
-		parseFormList(targetNode["ActorBase"], actorBases);
-		parseFormList(targetNode["Keyword"], keywords);
-		parseFormList(targetNode["Faction"], factions);
-		parseFormList(targetNode["Race"], races);
-		if (const auto conditionNode = targetNode["Conditions"]) {
-			const auto rawConditions = conditionNode.as<std::vector<std::string>>(std::vector<std::string>{});
-			conditions = Conditions::Conditional{
-				rawConditions,
-				a_node["RefMap"].as<std::map<std::string, std::string>>(std::map<std::string, std::string>{})
-			};
-		}
-		for (size_t i = 0; i < ProfileType::Total; i++) {
-			const auto profileIdx = static_cast<ProfileType>(i);
-			const auto indexKey = magic_enum::enum_name(profileIdx);
-			const auto profileNode = a_node[indexKey.data()];
-			if (!profileNode.IsDefined() || !profileNode.IsSequence()) {
-				continue;
-			}
-			auto& dest = profiles[i];
-			for (const auto& val : profileNode) {
-				const auto valStr = val.as<std::string>();
-				if (valStr == "*") {
-					// TODO: Wildcard should include all public ones, but still enable usage of private profiles
-					dest.clear();
-					a_distribution->ForEachProfile([&](std::shared_ptr<const ProfileBase> profil) {
-						dest.push_back(profil);
-					},
-						profileIdx);
-				} else {
-					const auto& profile = a_distribution->GetProfile(valStr, profileIdx);
-					if (profile) {
-						dest.push_back(profile);
-					} else {
-						logger::warn("Profile '{}' not found in any profile", valStr);
-					}
-				}
-			}
-		}
-	}
-
-	std::shared_ptr<const ProfileBase> Distribution::Configuration::SelectProfile(RE::Actor* a_target, ProfileType a_type) const
-	{
-		const auto& profileList = profiles[a_type];
-		std::vector<size_t> indices(profileList.size());
-		std::iota(indices.begin(), indices.end(), 0);
-		Random::shuffle(indices);
-		for (size_t idx : indices) {
-			if (profileList[idx]->IsApplicable(a_target)) {
-				return profileList[idx];
-			}
-		}
-		return nullptr;
-	}
-
-	Distribution::Configuration::MatchPriority Distribution::Configuration::GetMatchPriority(RE::Actor* a_target) const
-	{
-		if (conditions && !conditions.ConditionsMet(a_target, RE::PlayerCharacter::GetSingleton())) {
-			return MatchPriority::None;
-		} else if (isWildcardConfig) {
-			return MatchPriority::Wildcard;
-		} else if (std::ranges::contains(references, a_target->formID)) {
-			return MatchPriority::Reference;
-		}
-		const auto npc = a_target->GetActorBase();
-		const auto npcId = npc ? npc->GetFormID() : RE::FormID{ 0 };
-		if (std::ranges::contains(actorBases, npcId)) {
-			return MatchPriority::ActorBase;
-		} else if (std::ranges::any_of(factions, [&](RE::TESFaction* faction) { return a_target->IsInFaction(faction); }) ||
-				   a_target->HasKeywordInArray(keywords, false)) {
-			return MatchPriority::Group;
-		} else if (std::ranges::any_of(races, [&](RE::TESRace* race) { return race == npc->GetRace(); })) {
-			return MatchPriority::Race;
-		}
-		return MatchPriority::None;
-	}
-
 }  // namespace DBD
@@ -1,12 +1,12 @@
 #pragma once
 
-#include <yaml-cpp/yaml.h>
-
 #include "API/SKEE.h"
+#include "DBD/Configuration.h"
+#include "DBD/ConfigurationIndex.h"
 #include "DBD/SliderProfile.h"
+#include "DBD/Snapshot.h"
 #include "DBD/TextureProfile.h"
 #include "ProfileBase.h"
-#include "shared/KrisV/Conditions/Conditional.h"
 #include "shared/KrisV/Singleton.h"
 
 namespace DBD
@@ -19,39 +19,43 @@ namespace DBD
 		static constexpr const char* SLIDER_ROOT_PATH{ "Data\\SKSE\\DBD\\Sliders" };
 		static constexpr const char* SLIDER_DEFAULT_PATH{ "Data\\CalienteTools\\BodySlide\\SliderPresets" };
 		static constexpr const char* CONFIGURATION_ROOT_PATH{ "Data\\SKSE\\DBD\\Configurations" };
+		// Signatures differ only in targeted bases, races, factions and keywords, this is a safety net rather than a working limit
+		static constexpr size_t MAX_SIGNATURES{ 4096 };
 
-		struct Configuration
+		struct ConfigurationFile
+		{
+			std::string fileName;
+			std::optional<ConfigurationData> data;
+			std::string error;
+		};
+		using CacheEntry = std::pair<RE::FormID, ProfileArray<std::string>>;
+		using IndexedPriority = std::pair<uint32_t, Configuration::MatchPriority>;
+		// Configurations matching all actors of the same signature, sorted by index
+		struct SignatureMatch
 		{
-			enum MatchPriority
-			{
-				Reference,
-				ActorBase,
-				Group,
-				Race,
-				Wildcard,
-				None
-			};
-
-			Configuration(const YAML::Node& a_node, const Distribution* a_distribution);
-			~Configuration() = default;
-
-			std::shared_ptr<const ProfileBase> SelectProfile(RE::Actor* a_target, ProfileType a_type) const;
-			MatchPriority GetMatchPriority(RE::Actor* a_target) const;
-
-			ProfileArray<std::vector<std::shared_ptr<const ProfileBase>>> profiles;
-			bool isWildcardConfig{ false };
-			std::vector<RE::FormID> references{};
-			std::vector<RE::FormID> actorBases{};
-			std::vector<RE::BGSKeyword*> keywords{};
-			std::vector<RE::TESFaction*> factions{};
-			std::vector<RE::TESRace*> races{};
-			Conditions::Conditional conditions{};
+			uint64_t id;                           // Unique for every signature ever cached
+			std::vector<IndexedPriority> matches;  // Configs independent of the individual actor, with their final priority
+			std::vector<IndexedPriority> pending;  // Configs with references or conditions, with their shared priority
+		};
+		// State a selection was made in. Repeating it in the same state cannot select anything new
+		struct ResolveKey
+		{
+			uint32_t generation;               // Generation of the loaded configurations
+			uint64_t signature;                // Id of the signature match
+			uint64_t stamp;                    // Sum of the condition stamps of all configs evaluated per actor
+
+			bool operator==(const ResolveKey&) const = default;
 		};
 
 	public:
 		void Initialize();
+		bool IsReady() const { return ready.load(std::memory_order_acquire); }
 
 		ProfileArray<std::shared_ptr<const ProfileBase>> SelectProfiles(RE::Actor* a_target);
+		/// @brief Select profiles for many actors at once. Returns one entry per actor, in the same order
+		std::vector<ProfileArray<std::shared_ptr<const ProfileBase>>> SelectProfiles(std::span<RE::Actor* const> a_targets);
+		void ApplyProfiles(RE::Actor* a_target);
+		void ApplyProfiles(std::span<RE::Actor* const> a_targets);
 
 		bool ApplyProfile(RE::Actor* a_target, const std::string& a_profileId, ProfileType a_type);
 		bool ApplyTextureProfile(RE::Actor* a_target, const std::string& a_textureId);
@@ -68,22 +72,44 @@ namespace DBD
 	public:
 		void Save(SKSE::SerializationInterface* a_intfc, uint32_t a_version);
 		void Load(SKSE::SerializationInterface* a_intfc, uint32_t a_version);
+		void SaveSalt(SKSE::SerializationInterface* a_intfc, uint32_t a_version);
+		void LoadSalt(SKSE::SerializationInterface* a_intfc, uint32_t a_version);
 		void Revert(SKSE::SerializationInterface* a_intfc);
 
 	private:
 		void OnAttach(RE::TESObjectREFR* refr, RE::TESObjectARMO* armor, RE::TESObjectARMA* addon, RE::NiAVObject* object, bool isFirstPerson, RE::NiNode* skeleton, RE::NiNode* root) override;
 
-		void LoadTextureProfiles();
-		void LoadSliderProfiles();
-		void LoadConditions();
+		std::vector<ConfigurationFile> LoadData();
+		void FinishInitialize(const std::vector<ConfigurationFile>& a_configurationFiles);
+		void LoadTextureProfiles(ProfileSnapshot& a_snapshot);
+		void LoadSliderProfiles(ProfileSnapshot& a_snapshot);
+		std::vector<ConfigurationFile> LoadConditions();
+		void ResolveConditions(const std::vector<ConfigurationFile>& a_configurationFiles);
+		void ResolveCacheEntries(const std::vector<CacheEntry>& a_entries);
+		CounterEngine GetEngine(RE::Actor* a_target) const;
+		const SignatureMatch& GetSignatureMatch(RE::Actor* a_target);
+		ProfileArray<std::shared_ptr<const ProfileBase>> SelectActorProfiles(RE::Actor* a_target);
+		ResolveKey GetResolveKey(const std::vector<uint32_t>& a_references, const SignatureMatch& a_match) const;
 
 	private:
 		std::vector<Configuration> configurations;
+		ConfigurationIndex configurationIndex;
+		std::unordered_map<ConfigurationIndex::Signature, SignatureMatch, ConfigurationIndex::SignatureHash> signatureCache;  // Main thread only
+		uint64_t nextSignatureId{ 0 };
 		ProfileArray<std::map<std::string, std::shared_ptr<ProfileBase>, StringComparator>> profileMap;
 		std::map<RE::FormID, ProfileArray<std::shared_ptr<const ProfileBase>>> cache;
+		std::unordered_map<RE::FormID, ResolveKey> resolved;  // Key of the last selection for each entry in the cache
+		uint32_t generation{ 0 };
 		std::set<RE::FormID> excludedForms;
+		std::set<RE::FormID> pinnedForms;  // Actors whose profiles were assigned manually or restored from a save
+		uint64_t salt{ 0 };
 		RE::SEX playerSexPreChargen;
 
+		std::atomic<bool> ready{ false };
+		std::mutex pendingLock;
+		std::set<RE::FormID> pendingActors;
+		std::vector<CacheEntry> pendingCache;
+
 		SKEE::IActorUpdateManager* actorUpdateManager;
 		SKEE::IBodyMorphInterface* morphInterface;
 	};
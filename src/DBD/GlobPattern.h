@@ -0,0 +1,66 @@
+#pragma once
+
+namespace DBD
+{
+	/// @brief Case insensitive glob pattern supporting '*' (any sequence) and '?' (any single character)
+	/// The pattern is split into its '*'-separated segments once, matching then only needs a single pass over the input
+	class GlobPattern final
+	{
+	public:
+		GlobPattern(std::string_view a_pattern)
+		{
+			const auto segmentViews = a_pattern | std::views::split('*') | std::views::transform([](auto&& subrange) {
+				return std::string{ subrange.begin(), subrange.end() };
+			});
+			segments.assign(segmentViews.begin(), segmentViews.end());
+			hasStar = segments.size() > 1;
+		}
+
+		static bool IsPattern(std::string_view a_str)
+		{
+			return a_str.find_first_of("*?") != std::string_view::npos;
+		}
+
+		bool Matches(std::string_view a_str) const
+		{
+			if (!hasStar) {
+				return a_str.size() == segments.front().size() && SegmentAt(segments.front(), a_str, 0);
+			}
+			const auto& prefix = segments.front();
+			const auto& suffix = segments.back();
+			if (a_str.size() < prefix.size() + suffix.size() ||
+				!SegmentAt(prefix, a_str, 0) ||
+				!SegmentAt(suffix, a_str, a_str.size() - suffix.size())) {
+				return false;
+			}
+			// Every '*' can absorb arbitrary input, so taking the leftmost occurrence of each inner segment is sufficient
+			size_t pos = prefix.size();
+			const auto end = a_str.size() - suffix.size();
+			for (size_t i = 1; i + 1 < segments.size(); i++) {
+				const auto& segment = segments[i];
+				while (pos + segment.size() <= end && !SegmentAt(segment, a_str, pos))
+					pos++;
+				if (pos + segment.size() > end)
+					return false;
+				pos += segment.size();
+			}
+			return true;
+		}
+
+	private:
+		static bool SegmentAt(const std::string& a_segment, std::string_view a_str, size_t a_pos)
+		{
+			for (size_t i = 0; i < a_segment.size(); i++) {
+				const auto c = static_cast<unsigned char>(a_segment[i]);
+				if (c != '?' && std::tolower(c) != std::tolower(static_cast<unsigned char>(a_str[a_pos + i])))
+					return false;
+			}
+			return true;
+		}
+
+	private:
+		std::vector<std::string> segments;
+		bool hasStar;
+	};
+
+}  // namespace DBD
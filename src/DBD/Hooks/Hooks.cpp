@@ -2,7 +2,8 @@
 
 #include <detours.h>
 
-#include "DBD/Distribution.h"
+#include "DBD/ApplyQueue.h"
+#include "DBD/Scheduler.h"
 #include "shared/KrisV/Util/String.h"
 
 namespace DBD
@@ -16,14 +17,7 @@ namespace DBD
 			}
 
 			logger::info("Resetting 3D for Actor: {}", a_actor->formID);
-			const auto dist = DBD::Distribution::GetSingleton();
-			const auto profiles = dist->SelectProfiles(a_actor);
-
-			for (auto&& profile : profiles) {
-				if (profile) {
-					profile->Apply(a_actor);
-				}
-			}
+			ApplyQueue::GetSingleton()->Push(a_actor->formID);
 		}
 	}
 
@@ -31,6 +25,8 @@ namespace DBD
 	{
 		REL::Relocation<std::uintptr_t> char_vt{ RE::Character::VTABLE[0] };
 		_Load3D = char_vt.write_vfunc(0x6A, Load3D);
+		REL::Relocation<std::uintptr_t> player_vt{ RE::PlayerCharacter::VTABLE[0] };
+		_UpdatePlayer = player_vt.write_vfunc(0xAD, UpdatePlayer);
 
 		REL::Relocation<std::uintptr_t> target{ RELOCATION_ID(39181, 40255) };
 		const uintptr_t addr = target.address();
@@ -45,17 +41,18 @@ namespace DBD
 
 	RE::NiAVObject* Hooks::Load3D(RE::Character& a_this, bool a_arg1)
 	{
-		std::thread([id = a_this.formID]() {
-			// Im aware how ugly this is, but I couldn't find a hook in which this can be done 'cleanly'
-			std::this_thread::sleep_for(2s);
-			SKSE::GetTaskInterface()->AddTask([id]() {
-				auto actor = RE::TESForm::LookupByID<RE::Actor>(id);
-				ApplyProfile(actor);
-			});
-		}).detach();
+		// The 3D is only attached after this call returns, profiles are applied once it is
+		Scheduler::GetSingleton()->Schedule(a_this.formID);
 		return _Load3D(a_this, a_arg1);
 	}
 
+	void Hooks::UpdatePlayer(RE::PlayerCharacter& a_this, float a_delta)
+	{
+		_UpdatePlayer(a_this, a_delta);
+		Scheduler::GetSingleton()->Poll();
+		ApplyQueue::GetSingleton()->Process();
+	}
+
 	void Hooks::DoReset3D(RE::Actor& a_this, bool a_updateWeight)
 	{
 		_DoReset3D(a_this, a_updateWeight);
@@ -12,6 +12,9 @@ namespace DBD
 		static RE::NiAVObject* Load3D(RE::Character& a_this, bool a_arg1);
 		static inline REL::Relocation<decltype(Load3D)> _Load3D;
 
+		static void UpdatePlayer(RE::PlayerCharacter& a_this, float a_delta);
+		static inline REL::Relocation<decltype(UpdatePlayer)> _UpdatePlayer;
+
 		typedef void(WINAPI* DoReset3DType)(RE::Actor& a_this, bool a_updateWeight);
 		static void DoReset3D(RE::Actor& a_this, bool a_updateWeight);
 		static inline DoReset3DType _DoReset3D;
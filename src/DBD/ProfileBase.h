@@ -1,5 +1,7 @@
 #pragma once
 
+#include "DBD/Snapshot.h"
+
 namespace DBD
 {
 	enum ProfileType
@@ -25,17 +27,32 @@ namespace DBD
 				throw std::runtime_error("Profile name is empty");
 			}
 		}
+		ProfileBase(SnapshotReader& a_reader) :
+			name(a_reader.ReadString()), isPrivate(a_reader.Read<bool>()) {}
 		virtual ~ProfileBase() = default;
 
 		RE::BSFixedString GetName() const { return name; }
 		bool IsPrivate() const { return isPrivate; }
+		/// @brief Dense index among all loaded profiles, assigned once loading finished
+		uint32_t GetIndex() const { return index; }
+		void SetIndex(uint32_t a_index) { index = a_index; }
 
 		virtual void Apply(RE::Actor* a_target) const = 0;
 		virtual bool IsApplicable(RE::Actor* a_target) const = 0;
+		/// @brief Sex the profile is restricted to, kNone if it may apply to either
+		virtual RE::SEX GetSex() const { return RE::SEX::kNone; }
+		/// @brief If the profile is restricted to races with the ActorTypeNPC keyword
+		virtual bool RequiresNPCRace() const { return false; }
+		virtual void Write(SnapshotWriter& a_writer) const
+		{
+			a_writer.WriteString(name.c_str());
+			a_writer.Write(isPrivate);
+		}
 
 	protected:
 		RE::BSFixedString name;
 		bool isPrivate;
+		uint32_t index{ std::numeric_limits<uint32_t>::max() };
 	};
 
 }  // namespace DBD
@@ -0,0 +1,67 @@
+#include "Profiler.h"
+
+#include "DBD/Settings.h"
+
+namespace DBD
+{
+	Profiler::Scope::Scope(std::string_view a_phase, std::string a_file) :
+		enabled(Settings::profileStartup),
+		phase(a_phase),
+		file(std::move(a_file)),
+		start(std::chrono::steady_clock::now())
+	{}
+
+	Profiler::Scope::~Scope()
+	{
+		if (!enabled) {
+			return;
+		}
+		const auto time = std::chrono::steady_clock::now() - start;
+		std::scoped_lock guard{ lock };
+		records.emplace_back(phase, std::move(file), time, bytes, profiles);
+	}
+
+	void Profiler::Report()
+	{
+		if (!Settings::profileStartup) {
+			return;
+		}
+		std::vector<Record> data;
+		{
+			std::scoped_lock guard{ lock };
+			data = std::move(records);
+			records.clear();
+		}
+		const auto toMs = [](std::chrono::nanoseconds a_time) {
+			return std::chrono::duration<double, std::milli>(a_time).count();
+		};
+		logger::info("Startup profile:");
+		for (const auto& phase : data) {
+			if (!phase.file.empty())
+				continue;
+			auto total = phase;
+			uint64_t numFiles = 0;
+			for (const auto& file : data) {
+				if (file.file.empty() || file.phase != phase.phase)
+					continue;
+				numFiles++;
+				total.bytes += file.bytes;
+				total.profiles += file.profiles;
+			}
+			logger::info("\t{}: {:.2f} ms, {} files, {} bytes, {} profiles",
+				phase.phase, toMs(total.time), numFiles, total.bytes, total.profiles);
+		}
+		std::erase_if(data, [](const Record& a_record) { return a_record.file.empty(); });
+		const auto numSlowest = std::min<size_t>(Settings::profileTopFiles, data.size());
+		std::partial_sort(data.begin(), data.begin() + numSlowest, data.end(), [](const Record& a_lhs, const Record& a_rhs) {
+			return a_lhs.time > a_rhs.time;
+		});
+		logger::info("Top {} slowest files:", numSlowest);
+		for (size_t i = 0; i < numSlowest; i++) {
+			const auto& file = data[i];
+			logger::info("\t{:.2f} ms [{}] {} ({} bytes, {} profiles)",
+				toMs(file.time), file.phase, file.file, file.bytes, file.profiles);
+		}
+	}
+
+}  // namespace DBD
@@ -0,0 +1,51 @@
+#pragma once
+
+namespace DBD
+{
+	/// @brief Startup instrumentation. Records wall time, bytes read and profiles produced of each phase and file
+	class Profiler final
+	{
+	public:
+		Profiler() = delete;
+
+		class Scope
+		{
+		public:
+			/// @param a_phase The loading phase this scope belongs to
+			/// @param a_file The file measured by this scope, or empty if the scope measures the phase itself
+			Scope(std::string_view a_phase, std::string a_file = {});
+			~Scope();
+
+			Scope(const Scope&) = delete;
+			Scope& operator=(const Scope&) = delete;
+
+			void AddBytes(uint64_t a_bytes) { bytes += a_bytes; }
+			void AddProfiles(uint64_t a_profiles) { profiles += a_profiles; }
+
+		private:
+			bool enabled;
+			std::string_view phase;
+			std::string file;
+			std::chrono::steady_clock::time_point start;
+			uint64_t bytes{ 0 };
+			uint64_t profiles{ 0 };
+		};
+
+		/// @brief Log a summary of all phases and the slowest files, then discard all recorded data
+		static void Report();
+
+	private:
+		struct Record
+		{
+			std::string_view phase;
+			std::string file;
+			std::chrono::nanoseconds time;
+			uint64_t bytes;
+			uint64_t profiles;
+		};
+
+		static inline std::mutex lock{};
+		static inline std::vector<Record> records{};
+	};
+
+}  // namespace DBD
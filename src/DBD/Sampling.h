@@ -0,0 +1,97 @@
+#pragma once
+
+namespace DBD
+{
+	/// @brief Counter based random engine (SplitMix64), the n-th value only depends on the key and n
+	/// Cheap to create and without shared state, which makes it reproducible for a fixed key and safe to use from any thread
+	class CounterEngine final
+	{
+		static constexpr uint64_t GOLDEN_GAMMA{ 0x9e3779b97f4a7c15 };
+
+	public:
+		using result_type = uint64_t;
+
+		explicit CounterEngine(uint64_t a_key) :
+			key(a_key) {}
+
+		static constexpr result_type min() { return std::numeric_limits<result_type>::min(); }
+		static constexpr result_type max() { return std::numeric_limits<result_type>::max(); }
+
+		result_type operator()() { return Mix(key + GOLDEN_GAMMA * ++counter); }
+
+		static constexpr uint64_t Mix(uint64_t a_value)
+		{
+			a_value = (a_value ^ (a_value >> 30)) * 0xbf58476d1ce4e5b9;
+			a_value = (a_value ^ (a_value >> 27)) * 0x94d049bb133111eb;
+			return a_value ^ (a_value >> 31);
+		}
+
+	private:
+		uint64_t key;
+		uint64_t counter{ 0 };
+	};
+
+	/// @brief Walker/Vose alias table, drawing an index proportional to its weight in constant time
+	class AliasTable final
+	{
+	public:
+		AliasTable() = default;
+		AliasTable(std::span<const float> a_weights) :
+			probability(a_weights.size()), alias(a_weights.size())
+		{
+			const auto size = a_weights.size();
+			double total = 0.0;
+			for (const auto weight : a_weights) {
+				total += std::max(weight, 0.0f);
+			}
+			if (size == 0 || total <= 0.0) {
+				probability.clear();
+				alias.clear();
+				return;
+			}
+			std::vector<double> scaled(size);
+			std::vector<uint32_t> underfull{}, overfull{};
+			for (size_t i = 0; i < size; i++) {
+				scaled[i] = std::max(a_weights[i], 0.0f) * size / total;
+				(scaled[i] < 1.0 ? underfull : overfull).push_back(static_cast<uint32_t>(i));
+			}
+			while (!underfull.empty() && !overfull.empty()) {
+				const auto less = underfull.back();
+				const auto more = overfull.back();
+				underfull.pop_back();
+				probability[less] = static_cast<float>(scaled[less]);
+				alias[less] = more;
+				scaled[more] = (scaled[more] + scaled[less]) - 1.0;
+				if (scaled[more] < 1.0) {
+					overfull.pop_back();
+					underfull.push_back(more);
+				}
+			}
+			// Remaining entries are (up to rounding errors) exactly 1
+			for (const auto i : overfull) {
+				probability[i] = 1.0f;
+				alias[i] = i;
+			}
+			for (const auto i : underfull) {
+				probability[i] = 1.0f;
+				alias[i] = i;
+			}
+		}
+
+		bool empty() const { return probability.empty(); }
+
+		template <class E>
+		size_t Draw(E& a_engine) const
+		{
+			assert(!empty());
+			const auto column = std::uniform_int_distribution<size_t>{ 0, probability.size() - 1 }(a_engine);
+			const auto coin = std::uniform_real_distribution<float>{ 0.0f, 1.0f }(a_engine);
+			return coin < probability[column] ? column : alias[column];
+		}
+
+	private:
+		std::vector<float> probability{};
+		std::vector<uint32_t> alias{};
+	};
+
+}  // namespace DBD
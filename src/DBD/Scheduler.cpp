@@ -0,0 +1,123 @@
+#include "Scheduler.h"
+
+#include "DBD/ApplyQueue.h"
+#include "DBD/Settings.h"
+
+namespace DBD
+{
+	Scheduler::~Scheduler()
+	{
+		{
+			std::scoped_lock guard{ lock };
+			stopping = true;
+		}
+		wakeUp.notify_one();
+		if (thread.joinable()) {
+			thread.join();
+		}
+	}
+
+	void Scheduler::Schedule(RE::FormID a_formID)
+	{
+		{
+			std::scoped_lock guard{ lock };
+			const auto timeout = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<float>{ Settings::loadTimeout });
+			const auto time = Clock::now() + timeout;
+			due.insert_or_assign(a_formID, time);
+			queue.emplace(time, a_formID);
+			if (Settings::detectLoaded3D) {
+				if (!std::ranges::contains(watching, a_formID)) {
+					watching.push_back(a_formID);
+				}
+			}
+			if (!thread.joinable()) {
+				thread = std::thread([this]() { Run(); });
+			}
+		}
+		wakeUp.notify_one();
+	}
+
+	void Scheduler::Run()
+	{
+		std::unique_lock guard{ lock };
+		while (!stopping) {
+			if (queue.empty()) {
+				wakeUp.wait(guard, [this]() { return stopping || !queue.empty(); });
+				continue;
+			}
+			const auto next = queue.top().first;
+			if (Clock::now() < next) {
+				wakeUp.wait_until(guard, next);
+				continue;
+			}
+			std::vector<RE::FormID> ready;
+			const auto now = Clock::now();
+			while (!queue.empty() && queue.top().first <= now) {
+				const auto [time, formID] = queue.top();
+				queue.pop();
+				const auto it = due.find(formID);
+				if (it != due.end() && it->second == time) {
+					ready.push_back(formID);
+					due.erase(it);
+					std::erase(watching, formID);
+				}
+			}
+			if (ready.empty()) {
+				continue;
+			}
+			guard.unlock();
+			SKSE::GetTaskInterface()->AddTask([ready = std::move(ready)]() {
+				Dispatch(ready);
+			});
+			guard.lock();
+		}
+	}
+
+	void Scheduler::Poll()
+	{
+		std::vector<RE::FormID> pending;
+		{
+			std::scoped_lock guard{ lock };
+			if (watching.empty()) {
+				return;
+			}
+			pending = watching;
+		}
+		std::vector<RE::FormID> ready;
+		for (const auto formID : pending) {
+			const auto actor = RE::TESForm::LookupByID<RE::Actor>(formID);
+			if (!actor || (actor->Is3DLoaded() && actor->Get3D())) {
+				ready.push_back(formID);
+			}
+		}
+		if (ready.empty()) {
+			return;
+		}
+		{
+			std::scoped_lock guard{ lock };
+			// Actors handed over by the timeout thread in the meantime are no longer watched and must not be dispatched twice
+			std::erase_if(ready, [&](RE::FormID a_formID) { return !std::ranges::contains(watching, a_formID); });
+			for (const auto formID : ready) {
+				std::erase(watching, formID);
+				due.erase(formID);
+			}
+		}
+		if (!ready.empty()) {
+			Dispatch(ready);
+		}
+	}
+
+	void Scheduler::Dispatch(const std::vector<RE::FormID>& a_formIDs)
+	{
+		size_t numLoaded = 0;
+		for (const auto formID : a_formIDs) {
+			const auto actor = RE::TESForm::LookupByID<RE::Actor>(formID);
+			if (actor && actor->Is3DLoaded()) {
+				ApplyQueue::GetSingleton()->Push(formID);
+				numLoaded++;
+			}
+		}
+		logger::debug("Queued {} loaded actors, {} unloaded since", numLoaded, a_formIDs.size() - numLoaded);
+	}
+
+}  // namespace DBD
@@ -0,0 +1,39 @@
+#pragma once
+
+#include "shared/KrisV/Singleton.h"
+
+namespace DBD
+{
+	/// @brief Delays the application of profiles to freshly loaded actors until their 3D is attached
+	/// Requests are keyed by actor, a new request for an actor replaces its pending one. Pending actors are checked every
+	/// frame from the player update, a background thread hands over actors whose timeout expired. Actors becoming due
+	/// together are processed in a single task, actors which unloaded in the meantime are dropped.
+	class Scheduler final :
+		public Singleton<Scheduler>
+	{
+		using Clock = std::chrono::steady_clock;
+		using Entry = std::pair<Clock::time_point, RE::FormID>;
+
+	public:
+		~Scheduler();
+
+		void Schedule(RE::FormID a_formID);
+		/// @brief Dispatch watched actors whose 3D is attached, to be called once per frame on the main thread
+		void Poll();
+
+	private:
+		void Run();
+		static void Dispatch(const std::vector<RE::FormID>& a_formIDs);
+
+	private:
+		std::mutex lock;
+		std::condition_variable wakeUp;
+		// Min-heap of due times. Entries whose time differs from the one in `due` were replaced by a later request
+		std::priority_queue<Entry, std::vector<Entry>, std::greater<>> queue;
+		std::unordered_map<RE::FormID, Clock::time_point> due;
+		std::vector<RE::FormID> watching;  // Actors checked for their 3D every frame
+		std::thread thread;                // Hands over actors whose timeout expired, started with the first request
+		bool stopping{ false };
+	};
+
+}  // namespace DBD
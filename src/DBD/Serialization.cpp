@@ -11,6 +11,10 @@ namespace DBD
 			logger::error("Failed to open record <Defeated>");
 		else
 			Distribution::GetSingleton()->Save(a_intfc, _Version);
+		if (!a_intfc->OpenRecord(_Salt, _Version))
+			logger::error("Failed to open record <Salt>");
+		else
+			Distribution::GetSingleton()->SaveSalt(a_intfc, _Version);
 
 		logger::info("Finished writing data to cosave");
 	}
@@ -31,6 +35,9 @@ namespace DBD
 			case _Profiles:
 				Distribution::GetSingleton()->Load(a_intfc, _Version);
 				break;
+			case _Salt:
+				Distribution::GetSingleton()->LoadSalt(a_intfc, _Version);
+				break;
 			default:
 				logger::error("Unknown record type: {}", ty);
 				break;
@@ -12,7 +12,8 @@ namespace DBD
 		{
 			_Version = 1,
 
-			_Profiles = 'prf'
+			_Profiles = 'prf',
+			_Salt = 'slt'
 		};
 
 		static void SaveCallback(SKSE::SerializationInterface* a_intfc);
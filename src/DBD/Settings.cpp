@@ -0,0 +1,35 @@
+#include "Settings.h"
+
+#include <yaml-cpp/yaml.h>
+
+namespace DBD
+{
+	void Settings::Load()
+	{
+		if (!fs::exists(SETTINGS_PATH)) {
+			logger::info("No settings file found, using defaults");
+			return;
+		}
+		try {
+			const auto root = YAML::LoadFile(SETTINGS_PATH);
+			asyncInitialize = root["AsyncInitialize"].as<bool>(asyncInitialize);
+			deterministicDistribution = root["DeterministicDistribution"].as<bool>(deterministicDistribution);
+			applyBudget = root["ApplyBudget"].as<uint32_t>(applyBudget);
+			if (const auto load3D = root["Load3D"]) {
+				detectLoaded3D = load3D["DetectReady"].as<bool>(detectLoaded3D);
+				loadTimeout = std::max(load3D["Timeout"].as<float>(loadTimeout), 0.0f);
+			}
+			if (const auto profiler = root["Profiler"]) {
+				profileStartup = profiler["Enabled"].as<bool>(profileStartup);
+				profileTopFiles = profiler["TopFiles"].as<uint32_t>(profileTopFiles);
+			}
+			if (const auto conditions = root["Conditions"]) {
+				snapshotQuestVariables = conditions["SnapshotQuestVariables"].as<bool>(snapshotQuestVariables);
+			}
+		} catch (const std::exception& e) {
+			logger::error("Failed to load settings: {}", e.what());
+		}
+		logger::info("Settings: AsyncInitialize = {}, ApplyBudget = {}us, DeterministicDistribution = {}, Load3D = {} ({}s), Profiler = {} (Top {}), SnapshotQuestVariables = {}", asyncInitialize, applyBudget, deterministicDistribution, detectLoaded3D, loadTimeout, profileStartup, profileTopFiles, snapshotQuestVariables);
+	}
+
+}  // namespace DBD
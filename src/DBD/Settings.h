@@ -0,0 +1,32 @@
+#pragma once
+
+namespace DBD
+{
+	class Settings final
+	{
+		static constexpr const char* SETTINGS_PATH{ "Data\\SKSE\\DBD\\Settings.yml" };
+
+	public:
+		Settings() = delete;
+
+		static void Load();
+
+	public:
+		// Load profiles and configurations on a background thread instead of during the loading screen
+		static inline bool asyncInitialize{ false };
+		// Apply profiles to loaded actors as soon as their 3D is attached, instead of after a fixed delay
+		static inline bool detectLoaded3D{ true };
+		// Seconds to wait for the 3D of a loaded actor, or the fixed delay if detection is disabled
+		static inline float loadTimeout{ 2.0f };
+		// Microseconds per frame spent applying profiles, remaining actors are carried over to the next frame. 0 for no limit
+		static inline uint32_t applyBudget{ 2000 };
+		// Derive the random choices for an actor from its form and a per-save salt, instead of storing them in the cosave
+		static inline bool deterministicDistribution{ false };
+		// Log wall time, bytes read and profiles produced of every loading phase and file
+		static inline bool profileStartup{ false };
+		static inline uint32_t profileTopFiles{ 20 };
+		// Read quest variables used by conditions at most once per millisecond, instead of once for every actor evaluated
+		static inline bool snapshotQuestVariables{ false };
+	};
+
+}  // namespace DBD
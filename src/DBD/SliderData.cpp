@@ -0,0 +1,92 @@
+#include "SliderData.h"
+
+namespace DBD
+{
+	uint32_t SliderNames::Intern(std::string_view a_name)
+	{
+		{
+			std::shared_lock guard{ lock };
+			if (const auto it = ids.find(a_name); it != ids.end()) {
+				return it->second;
+			}
+		}
+		if (frozen.load(std::memory_order_acquire)) {
+			throw std::logic_error("Slider names are frozen");
+		}
+		std::unique_lock guard{ lock };
+		const auto [it, inserted] = ids.try_emplace(std::string{ a_name }, static_cast<uint32_t>(names.size()));
+		if (inserted) {
+			names.emplace_back(a_name);
+		}
+		return it->second;
+	}
+
+	const RE::BSFixedString& SliderNames::GetName(uint32_t a_id)
+	{
+		if (frozen.load(std::memory_order_acquire)) {
+			return names[a_id];
+		}
+		std::shared_lock guard{ lock };
+		return names[a_id];
+	}
+
+	std::shared_ptr<const SliderData> SliderData::Share(SliderData&& a_data)
+	{
+		const auto hash = a_data.Hash();
+		std::scoped_lock guard{ poolLock };
+		auto [begin, end] = pool.equal_range(hash);
+		for (auto it = begin; it != end; ++it) {
+			if (auto shared = it->second.lock(); shared && *shared == a_data) {
+				return shared;
+			}
+		}
+		auto ret = std::make_shared<const SliderData>(std::move(a_data));
+		// Reuse a slot whose data already expired before growing the pool
+		const auto expired = std::ranges::find_if(begin, end, [](const auto& entry) { return entry.second.expired(); });
+		if (expired != end) {
+			expired->second = ret;
+		} else {
+			pool.emplace(hash, ret);
+		}
+		return ret;
+	}
+
+	uint64_t SliderData::Hash() const
+	{
+		// FNV-1a
+		uint64_t hash = 0xcbf29ce484222325;
+		const auto combine = [&](std::span<const std::byte> a_bytes) {
+			for (const auto byte : a_bytes) {
+				hash ^= std::to_integer<uint64_t>(byte);
+				hash *= 0x100000001b3;
+			}
+		};
+		combine(std::as_bytes(std::span{ ids }));
+		combine(std::as_bytes(std::span{ minValues }));
+		combine(std::as_bytes(std::span{ maxValues }));
+		return hash;
+	}
+
+	void SliderData::Builder::Set(uint32_t a_id, bool a_isSmall, int32_t a_value)
+	{
+		entries.emplace_back(a_id, a_isSmall, a_value);
+	}
+
+	SliderData SliderData::Builder::Build()
+	{
+		// Stable sort to keep the last value set for a slider, same as assigning to a map would
+		std::ranges::stable_sort(entries, {}, &Entry::id);
+		SliderData ret{};
+		for (const auto& [id, isSmall, value] : entries) {
+			if (ret.ids.empty() || ret.ids.back() != id) {
+				ret.ids.push_back(id);
+				ret.minValues.push_back(0);
+				ret.maxValues.push_back(0);
+			}
+			(isSmall ? ret.minValues.back() : ret.maxValues.back()) = value;
+		}
+		entries.clear();
+		return ret;
+	}
+
+}  // namespace DBD
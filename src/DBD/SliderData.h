@@ -0,0 +1,58 @@
+#pragma once
+
+namespace DBD
+{
+	/// @brief Global table of slider names, assigning each (case insensitive) name a dense id
+	class SliderNames final
+	{
+	public:
+		SliderNames() = delete;
+
+		static uint32_t Intern(std::string_view a_name);
+		static const RE::BSFixedString& GetName(uint32_t a_id);
+		/// @brief Stop accepting new names, to be called once all profiles are loaded. Lookups no longer lock afterwards
+		static void Freeze() { frozen.store(true, std::memory_order_release); }
+
+	private:
+		static inline std::atomic<bool> frozen{ false };
+		static inline std::shared_mutex lock{};
+		static inline std::unordered_map<std::string, uint32_t, CaseInsensitiveHash, CaseInsensitiveEqual> ids{};
+		// Deque to keep references stable while new names are added
+		static inline std::deque<RE::BSFixedString> names{};
+	};
+
+	/// @brief Slider values of a profile, stored as parallel arrays sorted by slider id
+	struct SliderData
+	{
+		struct Builder
+		{
+			void Set(uint32_t a_id, bool a_isSmall, int32_t a_value);
+			SliderData Build();
+
+		private:
+			struct Entry
+			{
+				uint32_t id;
+				bool isSmall;
+				int32_t value;
+			};
+			std::vector<Entry> entries{};
+		};
+
+		/// @brief Get a shared, immutable copy of the given data. Identical slider sets share the same instance
+		static std::shared_ptr<const SliderData> Share(SliderData&& a_data);
+
+		size_t size() const { return ids.size(); }
+		uint64_t Hash() const;
+		bool operator==(const SliderData&) const = default;
+
+		std::vector<uint32_t> ids{};
+		std::vector<int32_t> minValues{};
+		std::vector<int32_t> maxValues{};
+
+	private:
+		static inline std::mutex poolLock{};
+		static inline std::unordered_multimap<uint64_t, std::weak_ptr<const SliderData>> pool{};
+	};
+
+}  // namespace DBD
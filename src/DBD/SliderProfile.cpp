@@ -1,7 +1,10 @@
 #include "SliderProfile.h"
 
+#include <charconv>
+
 #include <yaml-cpp/yaml.h>
 
+#include "DBD/Profiler.h"
 #include "shared/KrisV/Util/String.h"
 
 namespace DBD
@@ -10,7 +13,7 @@ namespace DBD
 		const std::filesystem::path& a_xmlfilePath,
 		RE::SEX a_sex,
 		SKEE::IBodyMorphInterface* a_interface,
-		SliderConfig* a_config)
+		const SliderConfig* a_config)
 	{
 		std::vector<std::shared_ptr<SliderProfile>> profiles{};
 		if (a_xmlfilePath.empty() || a_xmlfilePath.extension() != ".xml") {
@@ -22,16 +25,21 @@ namespace DBD
 		}
 		assert(a_sex != RE::SEX::kNone || a_config);
 		const bool isPrivate = a_xmlfilePath.c_str()[0] == '.';
-		std::ifstream file(a_xmlfilePath);
+		std::ifstream file(a_xmlfilePath, std::ios::binary);
 		if (!file) {
 			throw std::runtime_error("Failed to open XML file");
 		}
-		std::stringstream buffer;
-		buffer << file.rdbuf();
-		std::string content = buffer.str();
+		// Read the file in one go into a buffer that is reused by every file parsed on this thread, rapidxml then parses it in-situ
+		thread_local std::vector<char> content{};
+		const auto fileSize = static_cast<size_t>(std::filesystem::file_size(a_xmlfilePath));
+		content.resize(fileSize + 1);
+		if (!file.read(content.data(), fileSize)) {
+			throw std::runtime_error("Failed to read XML file");
+		}
+		content[fileSize] = '\0';
 
 		rapidxml::xml_document<> doc;
-		doc.parse<0>(&content[0]);
+		doc.parse<0>(content.data());
 		auto* root = doc.first_node("SliderPresets");
 		if (!root) {
 			const auto msg = std::format("Invalid <SliderPresets> element in {}", a_xmlfilePath.string());
@@ -51,7 +59,8 @@ namespace DBD
 			profiles.emplace_back(std::make_shared<SliderProfile>(preset, sex, isPrivate, a_interface));
 		}
 		if (!profiles.empty()) {
-			// Copy the first profile with the name of the .xml file into library, to allow referencing it by filename in configs
+			// Alias the first profile with the name of the .xml file into library, to allow referencing it by filename in configs
+			// The alias shares the slider data of the original profile
 			const auto copyFileName = std::make_shared<SliderProfile>(*profiles.front(), a_xmlfilePath.filename().string());
 			if (copyFileName->GetName() != profiles.front()->GetName()) {
 				profiles.push_back(copyFileName);
@@ -60,6 +69,53 @@ namespace DBD
 		return profiles;
 	}
 
+	std::vector<std::shared_ptr<SliderProfile>> SliderProfile::LoadProfiles(SnapshotReader& a_reader, SKEE::IBodyMorphInterface* a_interface)
+	{
+		if (!a_interface) {
+			throw std::runtime_error("Missing transform interface");
+		}
+		std::vector<std::shared_ptr<SliderProfile>> profiles{};
+		const auto numProfiles = a_reader.Read<uint32_t>();
+		profiles.reserve(numProfiles);
+		for (uint32_t i = 0; i < numProfiles; i++) {
+			profiles.emplace_back(std::make_shared<SliderProfile>(a_reader, a_interface));
+		}
+		return profiles;
+	}
+
+	void SliderProfile::WriteProfiles(SnapshotWriter& a_writer, const std::vector<std::shared_ptr<SliderProfile>>& a_profiles)
+	{
+		a_writer.Write(static_cast<uint32_t>(a_profiles.size()));
+		for (const auto& profile : a_profiles) {
+			profile->Write(a_writer);
+		}
+	}
+
+	SliderProfile::SliderProfile(SnapshotReader& a_reader, SKEE::IBodyMorphInterface* a_interface) :
+		ProfileBase(a_reader), sex(a_reader.Read<RE::SEX>()), transformInterface(a_interface)
+	{
+		SliderData::Builder builder{};
+		const auto numSliders = a_reader.Read<uint32_t>();
+		for (uint32_t i = 0; i < numSliders; i++) {
+			const auto id = SliderNames::Intern(a_reader.ReadString());
+			builder.Set(id, true, a_reader.Read<int32_t>());
+			builder.Set(id, false, a_reader.Read<int32_t>());
+		}
+		sliders = SliderData::Share(builder.Build());
+	}
+
+	void SliderProfile::Write(SnapshotWriter& a_writer) const
+	{
+		ProfileBase::Write(a_writer);
+		a_writer.Write(sex);
+		a_writer.Write(static_cast<uint32_t>(sliders->size()));
+		for (size_t i = 0; i < sliders->size(); i++) {
+			a_writer.WriteString(SliderNames::GetName(sliders->ids[i]).c_str());
+			a_writer.Write(sliders->minValues[i]);
+			a_writer.Write(sliders->maxValues[i]);
+		}
+	}
+
 	SliderProfile::SliderProfile(const rapidxml::xml_node<char>* a_node, RE::SEX a_sex, bool a_isPrivate, SKEE::IBodyMorphInterface* a_interface) :
 		ProfileBase([&]() -> const char* {
 			if (auto* attr = a_node->first_attribute("name"))
@@ -69,20 +125,27 @@ namespace DBD
 		sex(a_sex), transformInterface(a_interface)
 	{
 		this->isPrivate = a_isPrivate;
+		SliderData::Builder builder{};
 		for (auto* slider = a_node ? a_node->first_node("SetSlider") : nullptr; slider; slider = slider->next_sibling("SetSlider")) {
 			auto* nameAttr = slider->first_attribute("name");
 			auto* sizeAttr = slider->first_attribute("size");
 			auto* valueAttr = slider->first_attribute("value");
 			if (nameAttr && sizeAttr && valueAttr) {
-				std::string sliderName = nameAttr->value();
-				std::string size = sizeAttr->value();
-				int value = std::stoi(valueAttr->value());
-				auto& pair = sliders[sliderName];
-				(size == "small" ? pair.first : pair.second) = value;
+				const std::string_view sliderName{ nameAttr->value(), nameAttr->value_size() };
+				const std::string_view size{ sizeAttr->value(), sizeAttr->value_size() };
+				std::string_view valueStr{ valueAttr->value(), valueAttr->value_size() };
+				while (!valueStr.empty() && (std::isspace(static_cast<unsigned char>(valueStr.front())) || valueStr.front() == '+'))
+					valueStr.remove_prefix(1);
+				int32_t value;
+				if (std::from_chars(valueStr.data(), valueStr.data() + valueStr.size(), value).ec != std::errc{}) {
+					throw std::runtime_error(std::format("Invalid slider value '{}' in {}", valueStr, name.data()));
+				}
+				builder.Set(SliderNames::Intern(sliderName), size == "small"sv, value);
 			} else {
 				throw std::runtime_error(std::format("Invalid slider attributes in {}", name.data()));
 			}
 		}
+		sliders = SliderData::Share(builder.Build());
 	}
 
 	void SliderProfile::Apply(RE::Actor* a_target) const
@@ -91,10 +154,12 @@ namespace DBD
 		transformInterface->ClearBodyMorphKeys(a_target, MORPH_KEY);
 		const auto base = a_target->GetActorBase();
 		const auto weight = base ? base->weight / 100.0f : 0.5f;
-		for (const auto& [sliderName, sliderValues] : sliders) {
-			const auto& [minVal, maxVal] = sliderValues;
+		const auto& data = *sliders;
+		for (size_t i = 0; i < data.size(); i++) {
+			const auto minVal = data.minValues[i];
+			const auto maxVal = data.maxValues[i];
 			const float val{ ((maxVal - minVal) * weight) + minVal };
-			transformInterface->SetMorph(a_target, sliderName.data(), MORPH_KEY, val / 100.0f);
+			transformInterface->SetMorph(a_target, SliderNames::GetName(data.ids[i]).c_str(), MORPH_KEY, val / 100.0f);
 		}
 		transformInterface->ApplyBodyMorphs(a_target, false);
 		transformInterface->UpdateModelWeight(a_target, true);
@@ -117,54 +182,160 @@ namespace DBD
 		a_interface->UpdateModelWeight(a_target, true);
 	}
 
-	SliderConfig::SliderConfig()
+	SliderConfig::SliderConfig(ProfileSnapshot& a_snapshot)
 	{
+		Profiler::Scope phaseScope{ "SliderConfig" };
 		if (!fs::exists(CONFIG_PATH)) {
 			logger::error("Slider config path does not exist");
 			return;
 		}
+		std::vector<fs::path> files{};
+		ProfileSnapshot::Manifest manifest{};
 		for (auto& file : fs::recursive_directory_iterator{ CONFIG_PATH }) {
 			if (file.path().extension() != ".yml" && file.path().extension() != ".yaml")
 				continue;
+			files.push_back(file.path());
+			std::error_code ec;
+			manifest.emplace_back(file.path().string(), file.file_size(ec), file.last_write_time(ec).time_since_epoch().count());
+		}
+		// The hash covers every config file, so any added, removed or edited file invalidates the snapshot
+		hash = ProfileSnapshot::HashManifest(manifest);
+		if (auto reader = a_snapshot.Find(CONFIG_PATH, hash)) {
 			try {
-				const auto root = YAML::LoadFile(file.path().string());
-				if (const auto assignments = root["Assignments"])
-					for (auto&& node : root["Assignments"]) {
-						const auto nameStr = Util::CastLower(node.first.as<std::string>());
-						const auto sexStr = Util::CastLower(node.second.as<std::string>());
-						sexMapping[nameStr] = sexStr.starts_with("f") ? RE::SEX::kFemale : RE::SEX::kMale;
-					}
-				if (const auto exclusions = root["Excluded"])
-					for (auto&& node : exclusions) {
-						const auto nameStr = Util::CastLower(node.as<std::string>());
-						excludedPresets.push_back(nameStr);
-					}
+				Read(*reader);
+				a_snapshot.Reuse(CONFIG_PATH);
+				return;
 			} catch (const std::exception& e) {
-				logger::error("Failed to load slider config '{}': {}", file.path().filename().string(), e.what());
+				logger::warn("Failed to read slider config from snapshot: {}", e.what());
+				excludedPresets.clear();
+				excludedPatterns.clear();
+				sexMapping.clear();
+				sexPatterns.clear();
 			}
 		}
+		for (const auto& file : files) {
+			LoadFile(file);
+		}
+		SnapshotWriter writer{};
+		Write(writer);
+		a_snapshot.Store(CONFIG_PATH, hash, {}, writer.GetData());
+	}
+
+	void SliderConfig::LoadFile(const fs::path& a_file)
+	{
+		Profiler::Scope fileScope{ "SliderConfig", a_file.string() };
+		try {
+			std::error_code ec;
+			fileScope.AddBytes(fs::file_size(a_file, ec));
+			const auto root = YAML::LoadFile(a_file.string());
+			if (const auto assignments = root["Assignments"])
+				for (auto&& node : root["Assignments"]) {
+					const auto nameStr = node.first.as<std::string>();
+					const auto sexStr = Util::CastLower(node.second.as<std::string>());
+					AddAssignment(nameStr, sexStr.starts_with("f") ? RE::SEX::kFemale : RE::SEX::kMale);
+				}
+			if (const auto exclusions = root["Excluded"])
+				for (auto&& node : exclusions) {
+					AddExclusion(node.as<std::string>());
+				}
+		} catch (const std::exception& e) {
+			logger::error("Failed to load slider config '{}': {}", a_file.filename().string(), e.what());
+		}
+	}
+
+	void SliderConfig::AddExclusion(std::string_view a_name)
+	{
+		if (GlobPattern::IsPattern(a_name)) {
+			excludedPatterns.emplace_back(std::string{ a_name }, a_name, std::monostate{});
+		} else {
+			excludedPresets.emplace(a_name);
+		}
+	}
+
+	void SliderConfig::AddAssignment(std::string_view a_name, RE::SEX a_sex)
+	{
+		if (!GlobPattern::IsPattern(a_name)) {
+			sexMapping.insert_or_assign(std::string{ a_name }, a_sex);
+			return;
+		}
+		// Later assignments overwrite earlier ones, same as for plain names
+		const auto where = std::ranges::find(sexPatterns, a_name, &PatternRule<RE::SEX>::source);
+		if (where != sexPatterns.end()) {
+			where->value = a_sex;
+		} else {
+			sexPatterns.emplace_back(std::string{ a_name }, a_name, a_sex);
+		}
+	}
+
+	void SliderConfig::Read(SnapshotReader& a_reader)
+	{
+		const auto numExcluded = a_reader.Read<uint32_t>();
+		for (uint32_t i = 0; i < numExcluded; i++) {
+			AddExclusion(a_reader.ReadString());
+		}
+		const auto numAssignments = a_reader.Read<uint32_t>();
+		for (uint32_t i = 0; i < numAssignments; i++) {
+			const auto nameStr = a_reader.ReadString();
+			AddAssignment(nameStr, a_reader.Read<RE::SEX>());
+		}
+	}
+
+	void SliderConfig::Write(SnapshotWriter& a_writer) const
+	{
+		a_writer.Write(static_cast<uint32_t>(excludedPresets.size() + excludedPatterns.size()));
+		for (const auto& preset : excludedPresets) {
+			a_writer.WriteString(preset);
+		}
+		for (const auto& rule : excludedPatterns) {
+			a_writer.WriteString(rule.source);
+		}
+		a_writer.Write(static_cast<uint32_t>(sexMapping.size() + sexPatterns.size()));
+		for (const auto& [nameStr, sex] : sexMapping) {
+			a_writer.WriteString(nameStr);
+			a_writer.Write(sex);
+		}
+		for (const auto& rule : sexPatterns) {
+			a_writer.WriteString(rule.source);
+			a_writer.Write(rule.value);
+		}
 	}
 
 	bool SliderConfig::IsExcluded(const rapidxml::xml_node<char>* a_node) const
 	{
 		const auto nameAttr = a_node->first_attribute("name");
-		const auto nameStr = nameAttr ? nameAttr->value() : "unknown";
-		return std::ranges::contains(excludedPresets, Util::CastLower(nameStr));
+		const auto nameStr = nameAttr ? std::string_view{ nameAttr->value(), nameAttr->value_size() } : "unknown"sv;
+		if (excludedPresets.contains(nameStr)) {
+			return true;
+		}
+		return std::ranges::any_of(excludedPatterns, [&](const auto& rule) { return rule.pattern.Matches(nameStr); });
 	}
 
 	RE::SEX SliderConfig::GetSex(const rapidxml::xml_node<char>* a_node) const
 	{
-		for (auto* group = a_node ? a_node->first_node("Group") : nullptr; group; group = group->next_sibling("Group")) {
-			const auto* nameAttr = group->first_attribute("name");
-			if (!nameAttr) {
-				continue;
-			}
-			const auto nameStr = Util::CastLower(nameAttr->value());
-			if (const auto it = sexMapping.find(nameStr); it != sexMapping.end()) {
-				return it->second;
+		const auto forEachGroup = [&](auto a_visit) -> RE::SEX {
+			for (auto* group = a_node ? a_node->first_node("Group") : nullptr; group; group = group->next_sibling("Group")) {
+				const auto* nameAttr = group->first_attribute("name");
+				if (!nameAttr) {
+					continue;
+				}
+				const auto sex = a_visit(std::string_view{ nameAttr->value(), nameAttr->value_size() });
+				if (sex != RE::SEX::kNone) {
+					return sex;
+				}
 			}
+			return RE::SEX::kNone;
+		};
+		const auto sex = forEachGroup([&](std::string_view a_name) {
+			const auto it = sexMapping.find(a_name);
+			return it != sexMapping.end() ? it->second : RE::SEX::kNone;
+		});
+		if (sex != RE::SEX::kNone || sexPatterns.empty()) {
+			return sex;
 		}
-		return RE::SEX::kNone;
+		return forEachGroup([&](std::string_view a_name) {
+			const auto it = std::ranges::find_if(sexPatterns, [&](const auto& rule) { return rule.pattern.Matches(a_name); });
+			return it != sexPatterns.end() ? it->value : RE::SEX::kNone;
+		});
 	}
 
 }  // namespace DBD
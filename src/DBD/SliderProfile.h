@@ -4,6 +4,8 @@
 
 #include "API/SKEE.h"
 #include "ProfileBase.h"
+#include "GlobPattern.h"
+#include "SliderData.h"
 
 namespace DBD
 {
@@ -12,39 +14,63 @@ namespace DBD
 		constexpr static const char* CONFIG_PATH{ "Data\\SKSE\\DBD\\SliderConfig" };
 
 	public:
-		SliderConfig();
+		SliderConfig(ProfileSnapshot& a_snapshot);
 		~SliderConfig() = default;
 
 		bool IsExcluded(const rapidxml::xml_node<char>* a_node) const;
 		RE::SEX GetSex(const rapidxml::xml_node<char>* a_node) const;
+		uint64_t GetHash() const { return hash; }
 
 	private:
-		std::vector<std::string> excludedPresets{};
-		std::map<std::string, RE::SEX, StringComparator> sexMapping{};
+		void LoadFile(const fs::path& a_file);
+		void Read(SnapshotReader& a_reader);
+		void Write(SnapshotWriter& a_writer) const;
+		void AddExclusion(std::string_view a_name);
+		void AddAssignment(std::string_view a_name, RE::SEX a_sex);
+
+	private:
+		template <class T>
+		struct PatternRule
+		{
+			std::string source;
+			GlobPattern pattern;
+			T value;
+		};
+
+		// Plain names are resolved through hashed lookups, patterns are only tested if no plain name matches
+		std::unordered_set<std::string, CaseInsensitiveHash, CaseInsensitiveEqual> excludedPresets{};
+		std::vector<PatternRule<std::monostate>> excludedPatterns{};
+		std::unordered_map<std::string, RE::SEX, CaseInsensitiveHash, CaseInsensitiveEqual> sexMapping{};
+		std::vector<PatternRule<RE::SEX>> sexPatterns{};
+		uint64_t hash{ 0 };
 	};
 
 	class SliderProfile : public ProfileBase
 	{
-		using SliderRange = std::pair<int32_t, int32_t>;
-
 		constexpr static const char* MORPH_KEY = "DBD_Morph";
 
 	public:
-		static std::vector<std::shared_ptr<SliderProfile>> LoadProfiles(const std::filesystem::path& a_xmlfilePath, RE::SEX a_sex, SKEE::IBodyMorphInterface* a_interface, SliderConfig* a_config);
+		static std::vector<std::shared_ptr<SliderProfile>> LoadProfiles(const std::filesystem::path& a_xmlfilePath, RE::SEX a_sex, SKEE::IBodyMorphInterface* a_interface, const SliderConfig* a_config);
+		static std::vector<std::shared_ptr<SliderProfile>> LoadProfiles(SnapshotReader& a_reader, SKEE::IBodyMorphInterface* a_interface);
+		static void WriteProfiles(SnapshotWriter& a_writer, const std::vector<std::shared_ptr<SliderProfile>>& a_profiles);
 		SliderProfile(const rapidxml::xml_node<char>* a_node, RE::SEX a_sex, bool isPrivate, SKEE::IBodyMorphInterface* a_interface);
+		SliderProfile(SnapshotReader& a_reader, SKEE::IBodyMorphInterface* a_interface);
 		SliderProfile(const SliderProfile& a_other, RE::BSFixedString a_name) :
 			ProfileBase(a_name, ".xml"), sex(a_other.sex), transformInterface(a_other.transformInterface), sliders(a_other.sliders) {}
 		~SliderProfile() = default;
 
 		void Apply(RE::Actor* a_target) const override;
 		bool IsApplicable(RE::Actor* a_target) const override;
+		RE::SEX GetSex() const override { return sex; }
+		bool RequiresNPCRace() const override { return true; }
+		void Write(SnapshotWriter& a_writer) const override;
 
 		static void DeleteMorphs(RE::Actor* a_target, SKEE::IBodyMorphInterface* a_interface);
 
 	private:
 		RE::SEX sex;
 
-		std::map<std::string, SliderRange, StringComparator> sliders;
+		std::shared_ptr<const SliderData> sliders;
 		SKEE::IBodyMorphInterface* transformInterface;
 	};
 
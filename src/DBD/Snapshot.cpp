@@ -0,0 +1,263 @@
+#include "Snapshot.h"
+
+#include <Windows.h>
+
+namespace DBD
+{
+	void SnapshotWriter::WriteString(std::string_view a_str)
+	{
+		Write(static_cast<uint32_t>(a_str.size()));
+		WriteBytes(std::as_bytes(std::span{ a_str }));
+	}
+
+	void SnapshotWriter::WriteBytes(std::span<const std::byte> a_bytes)
+	{
+		data.insert(data.end(), a_bytes.begin(), a_bytes.end());
+	}
+
+	std::string_view SnapshotReader::ReadString()
+	{
+		const auto size = Read<uint32_t>();
+		const auto bytes = Consume(size);
+		return { reinterpret_cast<const char*>(bytes.data()), bytes.size() };
+	}
+
+	std::span<const std::byte> SnapshotReader::ReadBytes()
+	{
+		const auto size = Read<uint32_t>();
+		return Consume(size);
+	}
+
+	std::span<const std::byte> SnapshotReader::Consume(size_t a_size)
+	{
+		if (a_size > data.size()) {
+			throw std::out_of_range("Unexpected end of snapshot data");
+		}
+		const auto ret = data.first(a_size);
+		data = data.subspan(a_size);
+		return ret;
+	}
+
+	ProfileSnapshot::ProfileSnapshot()
+	{
+		if (!fs::exists(SNAPSHOT_PATH)) {
+			logger::info("No profile snapshot found, all profiles will be parsed from source");
+			return;
+		}
+		try {
+			Map();
+			SnapshotReader reader{ view };
+			if (reader.Read<uint32_t>() != MAGIC || reader.Read<uint32_t>() != VERSION) {
+				throw std::runtime_error("Outdated snapshot format");
+			}
+			const auto numRecords = reader.Read<uint32_t>();
+			for (uint32_t i = 0; i < numRecords; i++) {
+				const auto raw = reader.ReadBytes();
+				SnapshotReader recordReader{ raw };
+				const auto key = recordReader.ReadString();
+				auto& record = records[std::string{ key }];
+				record.raw = raw;
+				record.tag = recordReader.Read<uint64_t>();
+				const auto numEntries = recordReader.Read<uint32_t>();
+				record.manifest.reserve(numEntries);
+				for (uint32_t n = 0; n < numEntries; n++) {
+					auto& entry = record.manifest.emplace_back();
+					entry.path = recordReader.ReadString();
+					entry.size = recordReader.Read<uint64_t>();
+					entry.time = recordReader.Read<int64_t>();
+				}
+				record.payload = recordReader.ReadBytes();
+			}
+			logger::info("Loaded profile snapshot with {} sources", records.size());
+		} catch (const std::exception& e) {
+			logger::warn("Discarding profile snapshot: {}", e.what());
+			records.clear();
+			Unmap();
+		}
+	}
+
+	ProfileSnapshot::~ProfileSnapshot()
+	{
+		Unmap();
+	}
+
+	std::optional<SnapshotReader> ProfileSnapshot::Find(const std::string& a_key, uint64_t a_tag)
+	{
+		const auto it = records.find(a_key);
+		if (it == records.end()) {
+			return std::nullopt;
+		}
+		const auto& record = it->second;
+		if (record.tag != a_tag || !std::ranges::all_of(record.manifest, IsUpToDate)) {
+			return std::nullopt;
+		}
+		return SnapshotReader{ record.payload };
+	}
+
+	void ProfileSnapshot::Reuse(const std::string& a_key)
+	{
+		const auto it = records.find(a_key);
+		if (it == records.end()) {
+			return;
+		}
+		const auto& record = it->second;
+		std::scoped_lock guard{ lock };
+		output.emplace_back(record.raw.begin(), record.raw.end());
+		numReused++;
+	}
+
+	void ProfileSnapshot::Store(const std::string& a_key, uint64_t a_tag, const Manifest& a_manifest, std::span<const std::byte> a_payload)
+	{
+		SnapshotWriter writer{};
+		writer.WriteString(a_key);
+		writer.Write(a_tag);
+		writer.Write(static_cast<uint32_t>(a_manifest.size()));
+		for (const auto& entry : a_manifest) {
+			writer.WriteString(entry.path);
+			writer.Write(entry.size);
+			writer.Write(entry.time);
+		}
+		writer.Write(static_cast<uint32_t>(a_payload.size()));
+		writer.WriteBytes(a_payload);
+
+		std::scoped_lock guard{ lock };
+		output.push_back(writer.Release());
+		dirty = true;
+	}
+
+	void ProfileSnapshot::Commit()
+	{
+		const bool removedSources = numReused != records.size();
+		records.clear();
+		Unmap();
+		if (!dirty && !removedSources) {
+			logger::info("Profile snapshot is up to date");
+			return;
+		}
+		const fs::path target{ SNAPSHOT_PATH };
+		const auto tmpPath = fs::path{ target }.replace_extension(".tmp");
+		try {
+			{
+				std::ofstream file{ tmpPath, std::ios::binary | std::ios::trunc };
+				if (!file) {
+					throw std::runtime_error("Failed to open snapshot file for writing");
+				}
+				SnapshotWriter header{};
+				header.Write(MAGIC);
+				header.Write(VERSION);
+				header.Write(static_cast<uint32_t>(output.size()));
+				const auto writeBytes = [&](std::span<const std::byte> a_bytes) {
+					file.write(reinterpret_cast<const char*>(a_bytes.data()), a_bytes.size());
+				};
+				writeBytes(header.GetData());
+				for (const auto& record : output) {
+					const auto size = static_cast<uint32_t>(record.size());
+					writeBytes(std::as_bytes(std::span{ &size, 1 }));
+					writeBytes(record);
+				}
+				if (!file) {
+					throw std::runtime_error("Failed to write snapshot file");
+				}
+			}
+			fs::rename(tmpPath, target);
+			logger::info("Saved profile snapshot with {} sources", output.size());
+		} catch (const std::exception& e) {
+			logger::error("Failed to save profile snapshot: {}", e.what());
+			std::error_code ec;
+			fs::remove(tmpPath, ec);
+		}
+		output.clear();
+		numReused = 0;
+		dirty = false;
+	}
+
+	ProfileSnapshot::Manifest ProfileSnapshot::MakeFileManifest(const fs::path& a_file)
+	{
+		return { ManifestEntry{
+			a_file.string(),
+			fs::file_size(a_file),
+			fs::last_write_time(a_file).time_since_epoch().count() } };
+	}
+
+	ProfileSnapshot::Manifest ProfileSnapshot::MakeDirectoryManifest(const fs::path& a_directory)
+	{
+		// A directory's mtime changes whenever one of its direct children is added, removed or renamed.
+		// Tracking every (sub)directory thus allows to validate a folder without walking it.
+		Manifest ret{ ManifestEntry{ a_directory.string(), 0, fs::last_write_time(a_directory).time_since_epoch().count() } };
+		for (auto& entry : fs::recursive_directory_iterator{ a_directory }) {
+			if (!entry.is_directory())
+				continue;
+			ret.emplace_back(entry.path().string(), 0, entry.last_write_time().time_since_epoch().count());
+		}
+		return ret;
+	}
+
+	uint64_t ProfileSnapshot::HashManifest(const Manifest& a_manifest)
+	{
+		// FNV-1a
+		uint64_t hash = 0xcbf29ce484222325;
+		const auto combine = [&](std::span<const std::byte> a_bytes) {
+			for (const auto byte : a_bytes) {
+				hash ^= std::to_integer<uint64_t>(byte);
+				hash *= 0x100000001b3;
+			}
+		};
+		for (const auto& entry : a_manifest) {
+			combine(std::as_bytes(std::span{ entry.path }));
+			combine(std::as_bytes(std::span{ &entry.size, 1 }));
+			combine(std::as_bytes(std::span{ &entry.time, 1 }));
+		}
+		return hash;
+	}
+
+	bool ProfileSnapshot::IsUpToDate(const ManifestEntry& a_entry)
+	{
+		std::error_code ec;
+		const fs::directory_entry entry{ a_entry.path, ec };
+		if (ec || !entry.exists(ec)) {
+			return false;
+		}
+		const auto size = entry.is_directory(ec) ? 0 : entry.file_size(ec);
+		const auto time = entry.last_write_time(ec).time_since_epoch().count();
+		return !ec && size == a_entry.size && time == a_entry.time;
+	}
+
+	void ProfileSnapshot::Map()
+	{
+		file = CreateFileA(SNAPSHOT_PATH, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+		if (file == INVALID_HANDLE_VALUE) {
+			file = nullptr;
+			throw std::runtime_error("Failed to open snapshot file");
+		}
+		LARGE_INTEGER size;
+		if (!GetFileSizeEx(file, &size) || size.QuadPart == 0) {
+			throw std::runtime_error("Snapshot file is empty");
+		}
+		mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+		if (!mapping) {
+			throw std::runtime_error("Failed to map snapshot file");
+		}
+		const auto data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+		if (!data) {
+			throw std::runtime_error("Failed to view snapshot file");
+		}
+		view = { static_cast<const std::byte*>(data), static_cast<size_t>(size.QuadPart) };
+	}
+
+	void ProfileSnapshot::Unmap()
+	{
+		if (!view.empty()) {
+			UnmapViewOfFile(view.data());
+			view = {};
+		}
+		if (mapping) {
+			CloseHandle(mapping);
+			mapping = nullptr;
+		}
+		if (file) {
+			CloseHandle(file);
+			file = nullptr;
+		}
+	}
+
+}  // namespace DBD
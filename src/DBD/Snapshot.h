@@ -0,0 +1,114 @@
+#pragma once
+
+namespace DBD
+{
+	class SnapshotWriter
+	{
+	public:
+		SnapshotWriter() = default;
+		~SnapshotWriter() = default;
+
+		template <class T>
+			requires std::is_trivially_copyable_v<T>
+		void Write(const T& a_value)
+		{
+			const auto bytes = std::as_bytes(std::span{ std::addressof(a_value), 1 });
+			data.insert(data.end(), bytes.begin(), bytes.end());
+		}
+		void WriteString(std::string_view a_str);
+		void WriteBytes(std::span<const std::byte> a_bytes);
+
+		std::span<const std::byte> GetData() const { return data; }
+		std::vector<std::byte> Release() { return std::move(data); }
+
+	private:
+		std::vector<std::byte> data{};
+	};
+
+	class SnapshotReader
+	{
+	public:
+		SnapshotReader(std::span<const std::byte> a_data) :
+			data(a_data) {}
+		~SnapshotReader() = default;
+
+		template <class T>
+			requires std::is_trivially_copyable_v<T>
+		T Read()
+		{
+			T ret;
+			std::memcpy(std::addressof(ret), Consume(sizeof(T)).data(), sizeof(T));
+			return ret;
+		}
+		std::string_view ReadString();
+		std::span<const std::byte> ReadBytes();
+
+		bool IsEmpty() const { return data.empty(); }
+
+	private:
+		std::span<const std::byte> Consume(size_t a_size);
+
+	private:
+		std::span<const std::byte> data;
+	};
+
+	/// @brief Binary image of all parsed profile sources from a previous launch
+	/// Every source (texture folder, slider xml, slider config) is stored with a manifest of path, size and mtime and an
+	/// additional tag for values the source depends on. A source is only reused if both are still up to date.
+	class ProfileSnapshot
+	{
+		static constexpr const char* SNAPSHOT_PATH{ "Data\\SKSE\\DBD\\ProfileSnapshot.bin" };
+		static constexpr uint32_t MAGIC{ 'DBDS' };
+		static constexpr uint32_t VERSION{ 1 };
+
+	public:
+		struct ManifestEntry
+		{
+			std::string path;
+			uint64_t size;
+			int64_t time;
+		};
+		using Manifest = std::vector<ManifestEntry>;
+
+	public:
+		ProfileSnapshot();
+		~ProfileSnapshot();
+
+		/// @brief Get the payload of a source, if the source is still up to date. The payload stays valid until Commit()
+		std::optional<SnapshotReader> Find(const std::string& a_key, uint64_t a_tag);
+		/// @brief Keep the record of a source found above, once its payload was read successfully
+		void Reuse(const std::string& a_key);
+		void Store(const std::string& a_key, uint64_t a_tag, const Manifest& a_manifest, std::span<const std::byte> a_payload);
+		/// @brief Write the snapshot back to disk if any of its sources changed. Invalidates all readers
+		void Commit();
+
+		static Manifest MakeFileManifest(const fs::path& a_file);
+		static Manifest MakeDirectoryManifest(const fs::path& a_directory);
+		static uint64_t HashManifest(const Manifest& a_manifest);
+
+	private:
+		struct Record
+		{
+			uint64_t tag;
+			Manifest manifest;
+			std::span<const std::byte> payload;
+			std::span<const std::byte> raw;
+		};
+
+		void Map();
+		void Unmap();
+		static bool IsUpToDate(const ManifestEntry& a_entry);
+
+	private:
+		void* file{ nullptr };
+		void* mapping{ nullptr };
+		std::span<const std::byte> view{};
+		std::unordered_map<std::string, Record> records{};
+
+		std::mutex lock{};
+		std::vector<std::vector<std::byte>> output{};
+		size_t numReused{ 0 };
+		bool dirty{ false };
+	};
+
+}  // namespace DBD
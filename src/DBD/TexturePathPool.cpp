@@ -0,0 +1,29 @@
+#include "TexturePathPool.h"
+
+namespace DBD
+{
+	std::string_view TexturePathPool::Intern(std::string_view a_path)
+	{
+		std::scoped_lock guard{ lock };
+		if (const auto it = paths.find(a_path); it != paths.end()) {
+			return *it;
+		}
+		const auto size = a_path.size() + 1;
+		char* dest;
+		if (size > CHUNK_SIZE) {
+			// Oversized paths get their own allocation, keeping the current chunk open for further paths
+			dest = chunks.emplace(chunks.end() - (chunks.empty() ? 0 : 1), std::make_unique<char[]>(size))->get();
+		} else {
+			if (size > chunkRemaining) {
+				chunks.push_back(std::make_unique<char[]>(CHUNK_SIZE));
+				chunkRemaining = CHUNK_SIZE;
+			}
+			dest = chunks.back().get() + (CHUNK_SIZE - chunkRemaining);
+			chunkRemaining -= size;
+		}
+		std::memcpy(dest, a_path.data(), a_path.size());
+		dest[a_path.size()] = '\0';
+		return *paths.emplace(dest, a_path.size()).first;
+	}
+
+}  // namespace DBD
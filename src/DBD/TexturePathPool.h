@@ -0,0 +1,25 @@
+#pragma once
+
+namespace DBD
+{
+	/// @brief Global arena of texture paths shared by all texture profiles
+	/// Every (case insensitive) path is stored once, null terminated and never moves or is freed while the game runs,
+	/// which allows the game to keep pointers to it after a texture set has been created
+	class TexturePathPool final
+	{
+		static constexpr size_t CHUNK_SIZE{ 64 * 1024 };
+
+	public:
+		TexturePathPool() = delete;
+
+		/// @brief Get the pooled copy of the given path. The returned view is null terminated
+		static std::string_view Intern(std::string_view a_path);
+
+	private:
+		static inline std::mutex lock{};
+		static inline std::unordered_set<std::string_view, CaseInsensitiveHash, CaseInsensitiveEqual> paths{};
+		static inline std::vector<std::unique_ptr<char[]>> chunks{};
+		static inline size_t chunkRemaining{ 0 };
+	};
+
+}  // namespace DBD
@@ -1,5 +1,6 @@
 #include "TextureProfile.h"
 
+#include "DBD/TexturePathPool.h"
 #include "shared/KrisV/Util/String.h"
 
 namespace DBD
@@ -20,10 +21,50 @@ namespace DBD
 			// Idk if the c_str when setting texture path (see 'FillTextureSet') needs to be persistent, so I'd rather
 			// save the full path here, despite it being easily constructible from filePath, to avoid potential UB.
 			const auto filePathRaw = file.path().string();
-			const auto filePathFull = filePathRaw.substr(PREFIX_PATH.size() + 1);  // Remove "Data/Textures/"
-			const auto filePath = filePathFull.substr(profilePrefix.size() + 1);   // Remove "Data/Textures/DBD/<profile_name>/"
-			textures[filePath] = filePathFull;
+			const auto filePathFull = std::string_view{ filePathRaw }.substr(PREFIX_PATH.size() + 1);  // Remove "Data/Textures/"
+			const auto filePath = filePathFull.substr(profilePrefix.size() + 1);                      // Remove "Data/Textures/DBD/<profile_name>/"
+			textures.emplace_back(TexturePathPool::Intern(filePath), TexturePathPool::Intern(filePathFull));
 		}
+		SortTextures();
+	}
+
+	TextureProfile::TextureProfile(SnapshotReader& a_reader) :
+		ProfileBase(a_reader)
+	{
+		const auto numTextures = a_reader.Read<uint32_t>();
+		textures.reserve(numTextures);
+		for (uint32_t i = 0; i < numTextures; i++) {
+			const auto filePath = TexturePathPool::Intern(a_reader.ReadString());
+			textures.emplace_back(filePath, TexturePathPool::Intern(a_reader.ReadString()));
+		}
+		SortTextures();
+	}
+
+	void TextureProfile::Write(SnapshotWriter& a_writer) const
+	{
+		ProfileBase::Write(a_writer);
+		a_writer.Write(static_cast<uint32_t>(textures.size()));
+		for (const auto& [filePath, filePathFull] : textures) {
+			a_writer.WriteString(filePath);
+			a_writer.WriteString(filePathFull);
+		}
+	}
+
+	void TextureProfile::SortTextures()
+	{
+		std::ranges::sort(textures, CaseInsensitiveLess{}, [](const auto& entry) { return entry.first; });
+		const auto [first, last] = std::ranges::unique(textures, CaseInsensitiveEqual{}, [](const auto& entry) { return entry.first; });
+		textures.erase(first, last);
+		textures.shrink_to_fit();
+	}
+
+	const char* TextureProfile::FindTexture(std::string_view a_path) const
+	{
+		const auto it = std::ranges::lower_bound(textures, a_path, CaseInsensitiveLess{}, [](const auto& entry) { return entry.first; });
+		if (it == textures.end() || !CaseInsensitiveEqual{}(it->first, a_path)) {
+			return nullptr;
+		}
+		return it->second.data();
 	}
 
 	std::string TextureProfile::GetSubfolderKey(std::string a_path)
@@ -54,8 +95,8 @@ namespace DBD
 			if (path.starts_with(TEXTURE_PREFIX)) {
 				path = path.substr(TEXTURE_PREFIX.size() + 1);
 			}
-			if (const auto it = textures.find(path); it != textures.end()) {
-				texturePaths[i] = it->second.c_str();
+			if (const auto texture = FindTexture(path)) {
+				texturePaths[i] = texture;
 				hasOverwritten = true;
 			} else {
 				texturePaths[i] = pathCStr;
@@ -90,7 +131,7 @@ namespace DBD
 				continue;
 			for (size_t i = 0; i < Texture::kTotal; i++) {
 				const auto pathCStr = armaTextures->GetTexturePath(static_cast<Texture>(i));
-				if (pathCStr && textures.contains({ pathCStr })) {
+				if (pathCStr && FindTexture(pathCStr)) {
 					return true;
 				}
 			}
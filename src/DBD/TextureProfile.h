@@ -6,9 +6,6 @@ namespace DBD
 {
 	class TextureProfile : public ProfileBase
 	{
-		template <typename T = std::string>
-		using TextureMap = std::map<std::string, T, StringComparator>;
-
 		using VisitControl = RE::BSVisit::BSVisitControl;
 		using Feature = RE::BSLightingShaderMaterialBase::Feature;
 		using MaterialBase = RE::BSLightingShaderMaterialBase;
@@ -20,18 +17,24 @@ namespace DBD
 
 	public:
 		TextureProfile(const fs::directory_entry& a_textureFolder);
+		TextureProfile(SnapshotReader& a_reader);
 		~TextureProfile() = default;
 
 		void Apply(RE::Actor* a_target) const override;
 		bool IsApplicable(RE::Actor* a_target) const override;
 		void OverrideObjectTextures(RE::NiAVObject* a_object) const;
+		void Write(SnapshotWriter& a_writer) const override;
 
 	private:
 		RE::BSTextureSet* CreateOverwriteTextureSet(RE::BSTextureSet* a_sourceSet) const;
 		static std::string GetSubfolderKey(std::string a_path);
+		const char* FindTexture(std::string_view a_path) const;
+		void SortTextures();
 
 	private:
-		TextureMap<> textures;
+		// Pairs of (path relative to the profile folder, path relative to Data/Textures), sorted by the former
+		// Both point into the TexturePathPool
+		std::vector<std::pair<std::string_view, std::string_view>> textures;
 	};
 
 }  // namespace DBD
@@ -7,6 +7,10 @@
 #pragma warning(pop)
 
 #include <atomic>
+#include <condition_variable>
+#include <execution>
+#include <future>
+#include <queue>
 #include <unordered_map>
 
 #include "magic_enum.hpp"
@@ -66,6 +70,43 @@ struct StringComparator
 	}
 };
 
+struct CaseInsensitiveHash
+{
+	using is_transparent = void;
+
+	size_t operator()(std::string_view a_str) const
+	{
+		// FNV-1a
+		size_t hash = 14695981039346656037ull;
+		for (const char c : a_str) {
+			hash ^= static_cast<size_t>(std::tolower(static_cast<unsigned char>(c)));
+			hash *= 1099511628211ull;
+		}
+		return hash;
+	}
+};
+
+struct CaseInsensitiveEqual
+{
+	using is_transparent = void;
+
+	bool operator()(std::string_view lhs, std::string_view rhs) const
+	{
+		return lhs.size() == rhs.size() && _strnicmp(lhs.data(), rhs.data(), lhs.size()) == 0;
+	}
+};
+
+struct CaseInsensitiveLess
+{
+	using is_transparent = void;
+
+	bool operator()(std::string_view lhs, std::string_view rhs) const
+	{
+		const auto cmp = _strnicmp(lhs.data(), rhs.data(), std::min(lhs.size(), rhs.size()));
+		return cmp < 0 || (cmp == 0 && lhs.size() < rhs.size());
+	}
+};
+
 template <>
 struct std::formatter<RE::BSFixedString> : std::formatter<const char*>
 {
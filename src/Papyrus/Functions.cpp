@@ -1,5 +1,6 @@
 #include "Functions.h"
 
+#include "DBD/ApplicabilityCache.h"
 #include "DBD/Distribution.h"
 #include "DBD/SliderProfile.h"
 #include "DBD/TextureProfile.h"
@@ -20,7 +21,7 @@ namespace Papyrus
 	{
 		std::vector<RE::BSFixedString> profiles;
 		DBD::Distribution::GetSingleton()->ForEachTextureProfile([&](const DBD::TextureProfile* a_profile) {
-			if (!a_target || a_profile->IsApplicable(a_target)) {
+			if (!a_target || DBD::ApplicabilityCache::IsApplicable(a_profile, a_target)) {
 				profiles.emplace_back(a_profile->GetName());
 			}
 		});
@@ -31,7 +32,7 @@ namespace Papyrus
 	{
 		std::vector<RE::BSFixedString> profiles;
 		DBD::Distribution::GetSingleton()->ForEachSliderProfile([&](const DBD::SliderProfile* a_profile) {
-			if (!a_target || a_profile->IsApplicable(a_target)) {
+			if (!a_target || DBD::ApplicabilityCache::IsApplicable(a_profile, a_target)) {
 				profiles.emplace_back(a_profile->GetName());
 			}
 		});
@@ -1,6 +1,8 @@
+#include "DBD/ConditionProgram.h"
 #include "DBD/Distribution.h"
 #include "DBD/Hooks/Hooks.h"
 #include "DBD/Serialization.h"
+#include "DBD/Settings.h"
 #include "Papyrus/Functions.h"
 
 inline void SKSEMessageHandler(SKSE::MessagingInterface::Message* message)
@@ -9,10 +11,12 @@ inline void SKSEMessageHandler(SKSE::MessagingInterface::Message* message)
 	case SKSE::MessagingInterface::kSaveGame:
 		break;
 	case SKSE::MessagingInterface::kDataLoaded:
+		DBD::ConditionProgram::RegisterEventSinks();
 		DBD::Distribution::GetSingleton()->Initialize();
 		break;
 	case SKSE::MessagingInterface::kNewGame:
 	case SKSE::MessagingInterface::kPostLoadGame:
+		DBD::ConditionProgram::InvalidateBindings();
 		break;
 	}
 }
@@ -57,6 +61,8 @@ extern "C" DLLEXPORT bool SKSEAPI SKSEPlugin_Load(const SKSE::LoadInterface* a_s
 
 	SKSE::Init(a_skse);
 
+	DBD::Settings::Load();
+	DBD::ConditionProgram::SetQuestVariableSnapshot(DBD::Settings::snapshotQuestVariables);
 	DBD::Hooks::Install();
 
 	const auto msging = SKSE::GetMessagingInterface();